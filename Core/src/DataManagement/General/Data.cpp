@@ -50,6 +50,7 @@
 #include <QtXml>
 #include <QtXmlPatterns>
 #include <QProcess>
+#include <QStandardPaths>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -67,6 +68,22 @@
 
 std::mutex OpenInfraPlatform::Core::IfcGeometryConverter::ConverterBuwUtil::s_geometryMutex;
 
+namespace {
+	// The snapshots of imported files are cached per user, files on read-only media or in shared folders are never written to.
+	// Returns an empty path, i.e. the files are read without a snapshot, if the cache directory cannot be created.
+	std::string snapshotCacheDirectory()
+	{
+		const QString location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+		if (location.isEmpty())
+			return std::string();
+
+		const boost::filesystem::path directory = boost::filesystem::path(location.toStdWString()) / "snapshots";
+		boost::system::error_code error;
+		boost::filesystem::create_directories(directory, error);
+		return error ? std::string() : directory.string();
+	}
+}
+
 OpenInfraPlatform::Core::DataManagement::Data::Data() : 
 BlueFramework::Application::DataManagement::Data(new BlueFramework::Application::DataManagement::NotifiyAfterEachActionOnlyOnce<OpenInfraPlatform::Core::DataManagement::Data>()),
 clearColor_(0.3f, 0.5f, 0.9f),
@@ -159,7 +176,7 @@ void OpenInfraPlatform::Core::DataManagement::Data::importJob(const std::string&
 
 #ifdef OIP_MODULE_EARLYBINDING_IFC2X3
 		if (ifcSchema == IfcPeekStepReader::IfcSchema::IFC2X3) {
-			expressModel_ = OpenInfraPlatform::IFC2X3::IFC2X3Reader::FromFile(filename);
+			expressModel_ = OpenInfraPlatform::IFC2X3::IFC2X3Reader::FromFileCached(filename, snapshotCacheDirectory());
 			BLUE_LOG(info) << "Imported entities from " << filename << " into express model.";
 			auto importer = OpenInfraPlatform::Core::IfcGeometryConverter::IfcImporterT<emt::IFC2X3EntityTypes>();
 			if (importer.collectGeometryData(expressModel_)) {
@@ -174,7 +191,7 @@ void OpenInfraPlatform::Core::DataManagement::Data::importJob(const std::string&
 #endif // OIP_MODULE_EARLYBINDING_IFC2X3
 #ifdef OIP_MODULE_EARLYBINDING_IFC4
 		if (ifcSchema == IfcPeekStepReader::IfcSchema::IFC4) {
-			expressModel_ = OpenInfraPlatform::IFC4::IFC4Reader::FromFile(filename);
+			expressModel_ = OpenInfraPlatform::IFC4::IFC4Reader::FromFileCached(filename, snapshotCacheDirectory());
 			auto importer = OpenInfraPlatform::Core::IfcGeometryConverter::IfcImporterT<emt::IFC4EntityTypes>();
 			if (importer.collectGeometryData(expressModel_)) {
 				auto converter = IfcGeometryConverter::ConverterBuwT<emt::IFC4EntityTypes>();
@@ -193,7 +210,7 @@ void OpenInfraPlatform::Core::DataManagement::Data::importJob(const std::string&
 #endif //OIP_MODULE_EARLYBINDING_IFC4X1
 #ifdef OIP_MODULE_EARLYBINDING_IFC4X3_RC1
 		if (ifcSchema == IfcPeekStepReader::IfcSchema::IFC4X3_RC1) {
-			expressModel_ = OpenInfraPlatform::IFC4X3_RC1::IFC4X3_RC1Reader::FromFile(filename);
+			expressModel_ = OpenInfraPlatform::IFC4X3_RC1::IFC4X3_RC1Reader::FromFileCached(filename, snapshotCacheDirectory());
 			auto importer = OpenInfraPlatform::Core::IfcGeometryConverter::IfcImporterT<emt::IFC4X3_RC1EntityTypes>();
 			if (importer.collectGeometryData(expressModel_)) {
 				auto converter = IfcGeometryConverter::ConverterBuwT<emt::IFC4X3_RC1EntityTypes>();
@@ -222,7 +239,7 @@ void OpenInfraPlatform::Core::DataManagement::Data::importJob(const std::string&
 
 void OpenInfraPlatform::Core::DataManagement::Data::ParseExpressAndGeometryModel(const std::string &filename) {
 #ifdef OIP_MODULE_EARLYBINDING_IFC4X1
-	expressModel_ = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFile(filename);
+	expressModel_ = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFileCached(filename, snapshotCacheDirectory());
 	auto importer = OpenInfraPlatform::Core::IfcGeometryConverter::IfcImporterT<emt::IFC4X1EntityTypes>();
 	if (importer.collectGeometryData(expressModel_)) {
 		auto converter = IfcGeometryConverter::ConverterBuwT<emt::IFC4X1EntityTypes>();
@@ -0,0 +1,214 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// visual studio
+#pragma once
+// unix
+#ifndef CONVERSIONSCHEDULER_H
+#define CONVERSIONSCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "EXPRESS/EXPRESSEntityCast.h"
+#include "EXPRESS/EXPRESSModel.h"
+#include "EXPRESS/EXPRESSReference.h"
+
+namespace OpenInfraPlatform
+{
+	namespace Core
+	{
+		namespace IfcGeometryConverter
+		{
+			// Runs a job for every task on a pool of threads. Idle threads take the next task from a shared counter,
+			// so the threads finish at about the same time even if a few tasks take much longer than the others.
+			class ConversionScheduler
+			{
+			public:
+				static unsigned int threadCount(size_t numTasks)
+				{
+					return std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned int>(std::min<size_t>(numTasks, UINT_MAX))));
+				}
+
+				// Calls job(task, thread) for every task in the given order, thread is below threadCount(order.size()).
+				// The calling thread works on the tasks as well. If a job throws, the remaining tasks are skipped and
+				// the first exception is rethrown on the calling thread.
+				template <typename Job>
+				static void run(const std::vector<size_t>& order, const Job& job)
+				{
+					const unsigned int numThreads = threadCount(order.size());
+					std::atomic<size_t> next(0);
+					std::mutex exceptionMutex;
+					std::exception_ptr exception;
+
+					auto worker = [&](unsigned int thread) {
+						try {
+							for (size_t i = next++; i < order.size(); i = next++) {
+								job(order[i], thread);
+							}
+						}
+						catch (...) {
+							std::lock_guard<std::mutex> lock(exceptionMutex);
+							if (!exception)
+								exception = std::current_exception();
+							next = order.size();
+						}
+					};
+
+					std::vector<std::thread> threads;
+					for (unsigned int k = 1; k < numThreads; ++k) {
+						threads.push_back(std::thread(worker, k));
+					}
+					worker(0);
+					for (auto& thread : threads) {
+						thread.join();
+					}
+					if (exception)
+						std::rethrow_exception(exception);
+				}
+
+				// Orders the tasks by descending cost, tasks of equal cost keep their order.
+				static std::vector<size_t> orderByCost(const std::vector<double>& costs)
+				{
+					std::vector<size_t> order(costs.size());
+					std::iota(order.begin(), order.end(), 0);
+					std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+					return order;
+				}
+			};
+
+			// Estimates the relative time needed to convert a product from the types of its representation items.
+			// The estimate only has to rank the products, so that the expensive ones are converted first.
+			template <
+				class IfcEntityTypesT
+			>
+			class ConversionCostT
+			{
+			public:
+				ConversionCostT(const std::shared_ptr<oip::EXPRESSModel>& model)
+					: model(model)
+				{
+				}
+
+				double estimate(const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product) const
+				{
+					double cost = 1.0;
+					if (product->Representation) {
+						EXPRESSReference<typename IfcEntityTypesT::IfcProductRepresentation>& representation = product->Representation;
+						cost += estimateRepresentation(representation.lock(), 0);
+					}
+
+					// every opening is subtracted from the meshes of the element
+					std::shared_ptr<typename IfcEntityTypesT::IfcElement> element = oip::entityCast<typename IfcEntityTypesT::IfcElement>(product);
+					if (element) {
+						for (auto& relVoids : element->HasOpenings(*model)) {
+							EXPRESSReference<typename IfcEntityTypesT::IfcFeatureElementSubtraction>& opening = relVoids.RelatedOpeningElement;
+							if (!opening || !opening->Representation) {
+								continue;
+							}
+							EXPRESSReference<typename IfcEntityTypesT::IfcProductRepresentation>& representation = opening->Representation;
+							cost += booleanCost + estimateRepresentation(representation.lock(), 1);
+						}
+					}
+					return cost;
+				}
+
+			private:
+				// relative costs, a simple extrusion costs 1
+				static constexpr double booleanCost = 50.0;
+				static constexpr double sweptDiskSolidCost = 200.0;
+				static constexpr double advancedFaceCost = 20.0;
+				static constexpr double faceCost = 0.1;
+				// deeper boolean trees are not followed, which also stops at operands that refer back to the result
+				static constexpr int maxBooleanDepth = 32;
+
+				double estimateRepresentation(const std::shared_ptr<typename IfcEntityTypesT::IfcProductRepresentation>& representation, int booleanDepth) const
+				{
+					double cost = 0.0;
+					for (auto& rep : representation->Representations) {
+						cost += estimateItems(rep.lock(), booleanDepth);
+					}
+					return cost;
+				}
+
+				double estimateItems(const std::shared_ptr<typename IfcEntityTypesT::IfcRepresentation>& representation, int booleanDepth) const
+				{
+					double cost = 0.0;
+					for (auto& item : representation->Items) {
+						cost += estimateItem(item.lock(), booleanDepth);
+					}
+					return cost;
+				}
+
+				double estimateItem(const std::shared_ptr<oip::EXPRESSEntity>& item, int booleanDepth) const
+				{
+					if (!item) {
+						return 0.0;
+					}
+					item->decode();
+
+					// the operands of nested boolean results are the results of the inner operations, so deeper operations cost more
+					std::shared_ptr<typename IfcEntityTypesT::IfcBooleanResult> booleanResult = oip::entityCast<typename IfcEntityTypesT::IfcBooleanResult>(item);
+					if (booleanResult) {
+						double cost = booleanCost * (booleanDepth + 1);
+						if (booleanDepth >= maxBooleanDepth) {
+							return cost;
+						}
+						auto operand = [&](size_t id) { cost += estimateItem(model->entities.get(id), booleanDepth + 1); };
+						booleanResult->FirstOperand.forEachReference(operand);
+						booleanResult->SecondOperand.forEachReference(operand);
+						return cost;
+					}
+
+					std::shared_ptr<typename IfcEntityTypesT::IfcMappedItem> mappedItem = oip::entityCast<typename IfcEntityTypesT::IfcMappedItem>(item);
+					if (mappedItem) {
+						if (!mappedItem->MappingSource || !mappedItem->MappingSource->MappedRepresentation) {
+							return 1.0;
+						}
+						return estimateItems(mappedItem->MappingSource->MappedRepresentation.lock(), booleanDepth);
+					}
+
+					if (oip::isOfType<typename IfcEntityTypesT::IfcSweptDiskSolid>(item)) {
+						return sweptDiskSolidCost;
+					}
+
+					std::shared_ptr<typename IfcEntityTypesT::IfcManifoldSolidBrep> brep = oip::entityCast<typename IfcEntityTypesT::IfcManifoldSolidBrep>(item);
+					if (brep) {
+						if (!brep->Outer) {
+							return 1.0;
+						}
+						const double perFace = oip::isOfType<typename IfcEntityTypesT::IfcAdvancedBrep>(brep) ? advancedFaceCost : faceCost;
+						return 1.0 + perFace * brep->Outer->CfsFaces.size();
+					}
+
+					return 1.0;
+				}
+
+				std::shared_ptr<oip::EXPRESSModel> model;
+			};
+		}
+	}
+}
+
+#endif
@@ -19,13 +19,19 @@
 #define CONVERTERBUW_H
 
 #include <unordered_map>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <tuple>
 #include <thread>
 #include <mutex>
 
 #include <BlueFramework/Core/memory.h>
 #include <BlueFramework/Rasterizer/vertex.h>
 #include "CarveHeaders.h"
+#include "ConversionScheduler.h"
 #include "GeometryInputData.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 #include "namespace.h"
 
@@ -117,12 +123,55 @@ namespace OpenInfraPlatform
 				void reset() { indices.clear(); vertices.clear(); }
 			};
 
+			//! \brief An occurrence of a prototype mesh of IfcGeometryModel.
+			struct MeshInstance {
+				uint32_t			prototype;	//!< index into IfcGeometryModel::prototypes_
+				carve::math::Matrix	transform;	//!< from the coordinate system of the prototype to the model
+				int					productId;	//!< id of the IfcProduct the instance belongs to
+			};
+
 			struct IfcGeometryModel {
 				BoundingBox			   bb_;
 				IndexedMeshDescription meshDescription_;
 				PolylineDescription    polylineDescription_;
-				bool isEmpty() { return (meshDescription_.isEmpty() && polylineDescription_.isEmpty()); };
-				void reset() { bb_.reset(); meshDescription_.reset(); polylineDescription_.reset(); }
+				//! triangles shared by several products through IfcMappedItem, the instances are not part of meshDescription_
+				std::vector<IndexedMeshDescription> prototypes_;
+				std::vector<MeshInstance>			instances_;
+				bool isEmpty() { return (meshDescription_.isEmpty() && polylineDescription_.isEmpty() && instances_.empty()); };
+				void reset() { bb_.reset(); meshDescription_.reset(); polylineDescription_.reset(); prototypes_.clear(); instances_.clear(); }
+
+				/*!
+				 * \brief appends the triangles of all instances in model coordinates, for consumers that do not draw instances
+				 *
+				 * \param[in,out] vertices the vertices the instance vertices are appended to
+				 * \param[in,out] indices the indices the instance triangles are appended to, they refer to vertices
+				 */
+				void appendInstanceTriangles(std::vector<VertexLayout>& vertices, std::vector<uint32_t>& indices) const
+				{
+					for (const auto& instance : instances_) {
+						const IndexedMeshDescription& prototype = prototypes_[instance.prototype];
+						const carve::math::Matrix& m = instance.transform;
+
+						// normals are transformed by the cofactor matrix, which keeps them perpendicular under non-uniform scaling
+						const carve::geom::vector<3> c0 = carve::geom::VECTOR(m._11, m._12, m._13);
+						const carve::geom::vector<3> c1 = carve::geom::VECTOR(m._21, m._22, m._23);
+						const carve::geom::vector<3> c2 = carve::geom::VECTOR(m._31, m._32, m._33);
+						const carve::geom::vector<3> n0 = carve::geom::cross(c1, c2);
+						const carve::geom::vector<3> n1 = carve::geom::cross(c2, c0);
+						const carve::geom::vector<3> n2 = carve::geom::cross(c0, c1);
+
+						const uint32_t indexOffset = vertices.size();
+						for (const auto& vertex : prototype.vertices) {
+							const carve::geom::vector<3> position = m * carve::geom::VECTOR(vertex.position.x(), vertex.position.y(), vertex.position.z());
+							carve::geom::vector<3> normal = n0 * vertex.normal.x() + n1 * vertex.normal.y() + n2 * vertex.normal.z();
+							normal.normalize();
+							vertices.push_back(VertexLayout(buw::Vector3f(position.x, position.y, position.z), vertex.color,
+								buw::Vector3f(normal.x, normal.y, normal.z)));
+						}
+						for (const uint32_t index : prototype.indices)
+							indices.push_back(indexOffset + index);
+					}
+				}
 			};
 
 
@@ -141,6 +190,11 @@ namespace OpenInfraPlatform
 				class IfcEntityTypesT
 			>
 				class ConverterBuwT {
+				protected:
+					// prototype and color of the triangles
+					typedef std::tuple<const ItemData*, float, float, float> PrototypeKey;
+					typedef std::map<PrototypeKey, uint32_t> PrototypeIndices;
+
 				public:
 					// static const float FullyOpaqueAlphaThreshold;
 					// static const float FullyTransparentAlphaThreshold;
@@ -183,7 +237,7 @@ namespace OpenInfraPlatform
 						buw::Vector3f normal(face->plane.N.x, face->plane.N.y, face->plane.N.z);
 
 						// omit spaces
-						if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSpace>(product)) {
+						if(oip::isOfType<typename IfcEntityTypesT::IfcSpace>(product)) {
 							return false;//color.w() <= FullyOpaqueAlphaThreshold;
 						}
 
@@ -370,7 +424,8 @@ namespace OpenInfraPlatform
 
 					static bool insertPolylineIntoBuffers(const std::shared_ptr<carve::input::PolylineSetData> polylineData,
 						std::vector<buw::Vector3f>& vertices,
-						std::vector<uint32_t>& indices)
+						std::vector<uint32_t>& indices,
+						const carve::math::Matrix& matrix = carve::math::Matrix::IDENT())
 					{
 						// global offset of inserted vertices
 						const uint32_t vertexOffset = vertices.size();
@@ -384,7 +439,7 @@ namespace OpenInfraPlatform
 
 						// create vertex buffer for polylines
 						for(auto i = 0; i < vertexCount; ++i) {
-							carve::geom3d::Vector position = polylineData->getVertex(i);
+							carve::geom3d::Vector position = matrix * polylineData->getVertex(i);
 							buw::Vector3f vertex(position[0], position[1], position[2]);
 
 							/*const std::string vKey = createVertexKeyLine(vertex);
@@ -428,23 +483,51 @@ namespace OpenInfraPlatform
 						// clear all descriptions
 						ifcGeometryModel->reset();
 
-						// obtain maximum number of threads supported by machine
-						const unsigned int maxNumThreads = std::thread::hardware_concurrency();
+						// the geometry of a representation map is triangulated once per color, its mapped items only add an instance
+						PrototypeIndices prototypeIndices;
+						std::vector<BoundingBox> prototypeBoxes;
 
-						// split up tasks for all threads
-						std::vector<std::vector<std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>>> tasks(maxNumThreads);
-						uint32_t counter = 0;
+						// the triangulation time grows with the number of faces, the largest shapes are started first
+						std::vector<std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>> shapes;
+						std::vector<double> costs;
 						for(auto it = shapeDatas.begin(); it != shapeDatas.end(); ++it) {
-							std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>> shapeData = it->second;
-							tasks[counter % maxNumThreads].push_back(shapeData);
-							counter++;
+							const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product = it->second->ifc_product;
+							double cost = 1.0;
+							for(const auto& itemData : it->second->vec_item_data) {
+								if(isInstanced(product, itemData)) {
+									const PrototypeKey key = prototypeKey(product, itemData);
+									if(prototypeIndices.find(key) == prototypeIndices.end()) {
+										prototypeIndices[key] = ifcGeometryModel->prototypes_.size();
+										ifcGeometryModel->prototypes_.push_back(IndexedMeshDescription());
+										insertPrototypeIntoBuffers(product, *itemData->prototype, ifcGeometryModel->prototypes_.back());
+
+										prototypeBoxes.push_back(BoundingBox());
+										for (const auto& vertex : ifcGeometryModel->prototypes_.back().vertices)
+											prototypeBoxes.back().update(vertex.position[0], vertex.position[1], vertex.position[2]);
+									}
+									continue;
+								}
+								for(const auto& meshset : itemData->meshsets) {
+									cost += meshset->faceEnd() - meshset->faceBegin();
+								}
+							}
+							shapes.push_back(it->second);
+							costs.push_back(cost);
 						}
+						std::vector<std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>> tasks;
+						for(const size_t i : ConversionScheduler::orderByCost(costs)) {
+							tasks.push_back(shapes[i]);
+						}
+
+						// obtain maximum number of threads supported by machine
+						const unsigned int maxNumThreads = ConversionScheduler::threadCount(tasks.size());
 
-						// create threads and start creation job
+						// create threads and start creation job, idle threads take the next shape
+						std::atomic<size_t> nextTask(0);
 						std::vector<std::thread> threads(maxNumThreads);
 						// every thread gets its local triangle/polyline pool
 						for(unsigned int k = 0; k < maxNumThreads; ++k) {
-							threads[k] = std::thread(&ConverterBuwT<IfcEntityTypesT>::createTrianglesJob, tasks[k], k, ifcGeometryModel);
+							threads[k] = std::thread(&ConverterBuwT<IfcEntityTypesT>::createTrianglesJob, std::cref(tasks), std::ref(nextTask), std::cref(prototypeIndices), k, ifcGeometryModel);
 						}
 
 						// wait for all threads to be finished
@@ -452,13 +535,32 @@ namespace OpenInfraPlatform
 							threads[l].join();
 						}
 
+						// the threads append the instances in any order
+						std::stable_sort(ifcGeometryModel->instances_.begin(), ifcGeometryModel->instances_.end(),
+							[](const MeshInstance& a, const MeshInstance& b) { return a.productId < b.productId; });
+
+						// the corners of the bounding box of the prototype enclose the instance
+						for(const auto& instance : ifcGeometryModel->instances_) {
+							const BoundingBox& box = prototypeBoxes[instance.prototype];
+							if(box.isFirst) {
+								continue;
+							}
+							for(int corner = 0; corner < 8; ++corner) {
+								const carve::geom::vector<3> point = instance.transform * carve::geom::VECTOR(
+									corner & 1 ? box.max().x() : box.min().x(),
+									corner & 2 ? box.max().y() : box.min().y(),
+									corner & 4 ? box.max().z() : box.min().z());
+								ifcGeometryModel->bb_.update(point.x, point.y, point.z);
+							}
+						}
+
 						std::cout << "Info\t| IfcGeometryConverter.ConverterBuw: IFC model ready to be rendered" << std::endl;
 						return true;
 					}
 
 					// convert mesh and polyline descriptions to triangles/lines for BlueFramework
 					static void createTrianglesJob(const std::vector<std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>>& tasks,
-						int threadID, buw::ReferenceCounted<IfcGeometryModel>& ifcGeometryModel/*IndexedMeshDescription* meshDesc, PolylineDescription* polyDesc*/)
+						std::atomic<size_t>& nextTask, const PrototypeIndices& prototypeIndices, int threadID, buw::ReferenceCounted<IfcGeometryModel>& ifcGeometryModel/*IndexedMeshDescription* meshDesc, PolylineDescription* polyDesc*/)
 					{
 						//#ifdef _DEBUG
 						//				std::cout << "Info\t| IfcGeometryConverter.ConverterBuw: Starting thread " << threadID << " to create triangles and polylines" << std::endl;
@@ -466,12 +568,14 @@ namespace OpenInfraPlatform
 						BoundingBox bb;
 						IndexedMeshDescription threadMeshDesc;
 						PolylineDescription threadLineDesc;
+						std::vector<MeshInstance> threadInstances;
 
 						bb.reset();
 						threadMeshDesc.reset();
 						threadLineDesc.reset();
 
-						for(const auto& shapeData : tasks) {
+						for(size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+							const std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>& shapeData = tasks[i];
 							const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product = shapeData->ifc_product;
 
 							//#ifdef _DEBUG
@@ -480,9 +584,18 @@ namespace OpenInfraPlatform
 
 							for(const auto& itemData : shapeData->vec_item_data) {
 								// data for triangles
-								for(const auto& meshset : itemData->meshsets) {
-									ConverterBuwT<IfcEntityTypesT>::insertMeshSetIntoBuffers(product, meshset.get(),
-										threadMeshDesc.vertices, threadMeshDesc.indices);
+								if(isInstanced(product, itemData)) {
+									MeshInstance instance;
+									instance.prototype = prototypeIndices.at(prototypeKey(product, itemData));
+									instance.transform = itemData->prototype_transform;
+									instance.productId = product->getId();
+									threadInstances.push_back(instance);
+								}
+								else {
+									for(const auto& meshset : itemData->meshsets) {
+										ConverterBuwT<IfcEntityTypesT>::insertMeshSetIntoBuffers(product, meshset.get(),
+											threadMeshDesc.vertices, threadMeshDesc.indices);
+									}
 								}
 
 								// data for polylines
@@ -490,6 +603,13 @@ namespace OpenInfraPlatform
 									ConverterBuwT<IfcEntityTypesT>::insertPolylineIntoBuffers(polyline,
 										threadLineDesc.vertices, threadLineDesc.indices);
 								}
+								// items of a representation map hold no copy of the polylines of their prototype
+								if(itemData->prototype) {
+									for(const auto& polyline : itemData->prototype->polylines) {
+										ConverterBuwT<IfcEntityTypesT>::insertPolylineIntoBuffers(polyline,
+											threadLineDesc.vertices, threadLineDesc.indices, itemData->prototype_transform);
+									}
+								}
 							}
 						}
 
@@ -514,6 +634,7 @@ namespace OpenInfraPlatform
 						ifcGeometryModel->meshDescription_	  .indices .insert(ifcGeometryModel->meshDescription_	 .indices .end(), threadMeshDesc.indices .begin(), threadMeshDesc.indices .end());
 						ifcGeometryModel->polylineDescription_.vertices.insert(ifcGeometryModel->polylineDescription_.vertices.end(), threadLineDesc.vertices.begin(), threadLineDesc.vertices.end());
 						ifcGeometryModel->polylineDescription_.indices .insert(ifcGeometryModel->polylineDescription_.indices .end(), threadLineDesc.indices .begin(), threadLineDesc.indices .end());
+						ifcGeometryModel->instances_.insert(ifcGeometryModel->instances_.end(), threadInstances.begin(), threadInstances.end());
 						ifcGeometryModel->bb_.update(bb);
 
 						// free the access to the lists
@@ -526,69 +647,93 @@ namespace OpenInfraPlatform
 
 				protected:
 
+					// spaces are omitted, so their items are not instanced either
+					static bool isInstanced(const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product,
+						const std::shared_ptr<ItemData>& itemData)
+					{
+						return itemData->prototype && !oip::isOfType<typename IfcEntityTypesT::IfcSpace>(product);
+					}
+
+					static PrototypeKey prototypeKey(const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product,
+						const std::shared_ptr<ItemData>& itemData)
+					{
+						const buw::Vector3f color = determineColorFromBaseTypes(product);
+						return PrototypeKey(itemData->prototype.get(), color.x(), color.y(), color.z());
+					}
+
+					// the prototype holds only simplified meshsets, its polyhedrons are converted when it is added to the RepresentationMapCache
+					static void insertPrototypeIntoBuffers(const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product,
+						const ItemData& prototype,
+						IndexedMeshDescription& meshDesc)
+					{
+						for(const auto& meshset : prototype.meshsets) {
+							insertMeshSetIntoBuffers(product, meshset.get(), meshDesc.vertices, meshDesc.indices);
+						}
+					}
+
 					static buw::Vector3f determineColorFromBaseTypes(
 						const std::shared_ptr<typename IfcEntityTypesT::IfcProduct>& product)
 					{
-						if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcWindow>(product)) {
+						if(oip::isOfType<typename IfcEntityTypesT::IfcWindow>(product)) {
 							return buw::Vector3f(0.1f, 0.6f, 1.0f);//, 0.4f);
 						}
 
 						// Balken
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBeam>(product)
-							|| std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcColumn>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcBeam>(product)
+							|| oip::isOfType<typename IfcEntityTypesT::IfcColumn>(product)) {
 							return buw::Vector3f(0.4f, 0.4f, 0.4f);//, 1.0f);
 						}
 
 						// ignore spaces!
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSpace>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcSpace>(product)) {
 							return buw::Vector3f(0.1f, 0.2f, 1.0f);//, 1.0f);
 						}
 
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcDoor>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcDoor>(product)) {
 							return buw::Vector3f(0.8f, 0.6f, 0.2f);//, 0.5f);
 						}
 
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRoof>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcRoof>(product)) {
 							return buw::Vector3f(0.6f, 0.15f, 0.15f);//, 1.0f);
 						}
 
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcStair>(product)
-							|| std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcStairFlight>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcStair>(product)
+							|| oip::isOfType<typename IfcEntityTypesT::IfcStairFlight>(product)) {
 							return buw::Vector3f(0.8f, 0.4f, 0.4f);//, 1.0f);
 						}
 
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRamp>(product)
-							|| std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRampFlight>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcRamp>(product)
+							|| oip::isOfType<typename IfcEntityTypesT::IfcRampFlight>(product)) {
 							return buw::Vector3f(0.6f, 0.6f, 0.4f);//, 1.0f);
 						}
 
 						// Gelnder
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRailing>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcRailing>(product)) {
 							return buw::Vector3f(0.7f, 0.7f, 0.2f);//, 1.0f);
 						}
 
 						// Gelnder
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPile>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcPile>(product)) {
 							return buw::Vector3f(0.15f, 0.7f, 0.0f);//, 1.0f);
 						}
 
 						// Mbel
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcFurnishingElement>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcFurnishingElement>(product)) {
 							return buw::Vector3f(0.8f, 0.6f, 0.2f);//, 1.0f);
 						}
 						// Land
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSite>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcSite>(product)) {
 							return buw::Vector3f(0.1f, 0.5f, 0.1f);//, 1.0f);
 						}
 						// Wasser/Gas Elemente
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcFlowTerminal>(product)
-							|| std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcDistributionFlowElement>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcFlowTerminal>(product)
+							|| oip::isOfType<typename IfcEntityTypesT::IfcDistributionFlowElement>(product)) {
 							return buw::Vector3f(0.4f, 0.4f, 0.6f);//, 1.0f);
 						}
 						// Platte als Dach oder Gelnder?
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSlab>(product)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcSlab>(product)) {
 							const std::shared_ptr<typename IfcEntityTypesT::IfcSlab>& slab =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSlab>(product);
+								oip::entityCast<typename IfcEntityTypesT::IfcSlab>(product);
 
 							if(slab->PredefinedType) {
 								// Dach
@@ -629,6 +774,7 @@ namespace OpenInfraPlatform
 }
 
 EMBED_CORE_IFCGEOMETRYCONVERTER_INTO_OIP_NAMESPACE(BoundingBox)
+EMBED_CORE_IFCGEOMETRYCONVERTER_INTO_OIP_NAMESPACE(MeshInstance)
 EMBED_CORE_IFCGEOMETRYCONVERTER_INTO_OIP_NAMESPACE(IfcGeometryModel)
 
 #endif
\ No newline at end of file
@@ -32,6 +32,7 @@
 #include "SplineConverter.h"
 
 #include "BlueFramework/Core/Diagnostics/log.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 
 namespace OpenInfraPlatform {
@@ -152,12 +153,12 @@ namespace OpenInfraPlatform {
 					//	ABSTRACT SUPERTYPE of IfcAlignmentCurve, IfcBsplineCurve, IfcCompositeCurve, IfcIndexedPolycurve, IfcPolyline, IfcIfcTrimmedCurve	//
 					// ************************************************************************************************************************************	//
 					std::shared_ptr<typename IfcEntityTypesT::IfcBoundedCurve> bounded_curve =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBoundedCurve>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcBoundedCurve>(ifcCurve);
 					if (bounded_curve)
 					{
 						// (1/6) IfcAlignmentCurve SUBTYPE OF IfcBoundedCurve
 						std::shared_ptr<typename IfcEntityTypesT::IfcAlignmentCurve> alignment_curve =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignmentCurve>(bounded_curve);
+							oip::entityCast<typename IfcEntityTypesT::IfcAlignmentCurve>(bounded_curve);
 						if (alignment_curve) 
 						{
 							// **************************************************************************************************************************** //
@@ -247,11 +248,11 @@ namespace OpenInfraPlatform {
 								// Segment types: IfcLineSegment2D, IfcCircularArcSegment2D and IfcTransitionCurveSegment2D
 								// https://standards.buildingsmart.org/IFC/RELEASE/IFC4_1/FINAL/HTML/schema/ifcgeometryresource/lexical/ifccurvesegment2d.htm
 								std::shared_ptr<typename IfcEntityTypesT::IfcLineSegment2D> line_segment_2D =
-									std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcLineSegment2D>(horCurveGeometry);
+									oip::entityCast<typename IfcEntityTypesT::IfcLineSegment2D>(horCurveGeometry);
 								std::shared_ptr<typename IfcEntityTypesT::IfcCircularArcSegment2D> circular_arc_segment_2D =
-									std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCircularArcSegment2D>(horCurveGeometry);
+									oip::entityCast<typename IfcEntityTypesT::IfcCircularArcSegment2D>(horCurveGeometry);
 								std::shared_ptr<typename IfcEntityTypesT::IfcTransitionCurveSegment2D> trans_curve_segment_2D =
-									std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTransitionCurveSegment2D>(horCurveGeometry);
+									oip::entityCast<typename IfcEntityTypesT::IfcTransitionCurveSegment2D>(horCurveGeometry);
 								
 								// Set number of fragments (number of stations to be added within segment) according to segment type.
 								// depending on the (smallest) segment radius.
@@ -344,11 +345,11 @@ namespace OpenInfraPlatform {
 
 									// Segment types: IfcAlignment2DVerSegCircularArc, IfcAlignment2DVerSegLine, IfcAlignment2DVerSegParabolicArc.
 									std::shared_ptr<typename IfcEntityTypesT::IfcAlignment2DVerSegCircularArc> v_seg_circ_arc_2D =
-										std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment2DVerSegCircularArc>(itVerticalSegment->lock());
+										oip::entityCast<typename IfcEntityTypesT::IfcAlignment2DVerSegCircularArc>(itVerticalSegment->lock());
 									std::shared_ptr<typename IfcEntityTypesT::IfcAlignment2DVerSegLine> v_seg_line_2D =
-										std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment2DVerSegLine>(itVerticalSegment->lock());
+										oip::entityCast<typename IfcEntityTypesT::IfcAlignment2DVerSegLine>(itVerticalSegment->lock());
 									std::shared_ptr<typename IfcEntityTypesT::IfcAlignment2DVerSegParabolicArc> v_seg_par_arc_2D =
-										std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment2DVerSegParabolicArc>(itVerticalSegment->lock());
+										oip::entityCast<typename IfcEntityTypesT::IfcAlignment2DVerSegParabolicArc>(itVerticalSegment->lock());
 
 									// Set number of fragments (number of stations to be added within segment) according to segment type.
 									// depending on the segment radius.
@@ -437,7 +438,7 @@ namespace OpenInfraPlatform {
 
 						// (2/6) IfcBSplineCurve SUBTYPE OF IfcBoundedCurve
 						std::shared_ptr<typename IfcEntityTypesT::IfcBSplineCurve> bspline_curve =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBSplineCurve>(bounded_curve);
+							oip::entityCast<typename IfcEntityTypesT::IfcBSplineCurve>(bounded_curve);
 						if (bspline_curve) {
 
 							std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcCartesianPoint>> points;
@@ -463,7 +464,7 @@ namespace OpenInfraPlatform {
 
 						// (3/6) IfcCompositeCurve SUBTYPE OF IfcBoundedCurve
 						std::shared_ptr<typename IfcEntityTypesT::IfcCompositeCurve> composite_curve =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCompositeCurve>(bounded_curve);
+							oip::entityCast<typename IfcEntityTypesT::IfcCompositeCurve>(bounded_curve);
 						if (composite_curve) {
 
 							std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcCompositeCurveSegment> > segments;
@@ -502,7 +503,7 @@ namespace OpenInfraPlatform {
 
 						// (5/6) IfcPolyline SUBTYPE OF IfcBoundedCurve
 						std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> poly_line =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyline>(bounded_curve);
+							oip::entityCast<typename IfcEntityTypesT::IfcPolyline>(bounded_curve);
 						if (poly_line) {
 							if ( !poly_line->Points.empty() ) {
 								std::vector<carve::geom::vector<3>> loop;
@@ -516,7 +517,7 @@ namespace OpenInfraPlatform {
 
 						// (6/6) IfcTrimmedCurve SUBTYPE OF IfcBoundedCurve
 						std::shared_ptr<typename IfcEntityTypesT::IfcTrimmedCurve> trimmed_curve =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTrimmedCurve>(bounded_curve);
+							oip::entityCast<typename IfcEntityTypesT::IfcTrimmedCurve>(bounded_curve);
 						if (trimmed_curve) {
 							std::shared_ptr<typename IfcEntityTypesT::IfcCurve> basis_curve = trimmed_curve->BasisCurve.lock();
 							std::vector<carve::geom::vector<3> > basis_curve_points;
@@ -551,7 +552,7 @@ namespace OpenInfraPlatform {
 					//	ABSTRACT SUPERTYPE of IfcCircle, IfcEllipse																				//
 					// ************************************************************************************************************************	//
 					std::shared_ptr<typename IfcEntityTypesT::IfcConic> conic =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcConic>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcConic>(ifcCurve);
 					if (conic) {
 						// determine position
 						typename IfcEntityTypesT::IfcAxis2Placement conic_placement = conic->Position;
@@ -575,7 +576,7 @@ namespace OpenInfraPlatform {
 
 						// (1/2) IfcCircle SUBTYPE OF IfcConic
 						std::shared_ptr<typename IfcEntityTypesT::IfcCircle> circle =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCircle>(conic);
+							oip::entityCast<typename IfcEntityTypesT::IfcCircle>(conic);
 						if (circle) {
 							// Get radius
 							double circle_radius = 0.0;
@@ -733,7 +734,7 @@ namespace OpenInfraPlatform {
 
 						// (2/2) IfcEllipse SUBTYPE OF IfcConic
 						std::shared_ptr<typename IfcEntityTypesT::IfcEllipse> ellipse =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcEllipse>(conic);
+							oip::entityCast<typename IfcEntityTypesT::IfcEllipse>(conic);
 						if (ellipse) {
 							if (ellipse->SemiAxis1) {
 								if (ellipse->SemiAxis2) {
@@ -781,7 +782,7 @@ namespace OpenInfraPlatform {
 					//	IfcLine SUPTYPE of IfcCurve																								//
 					// ************************************************************************************************************************	//
 					std::shared_ptr<typename IfcEntityTypesT::IfcLine> line =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcLine>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcLine>(ifcCurve);
 					if (line)
 					{
 						// Part 1: Get information from IfcLine. 
@@ -900,7 +901,7 @@ namespace OpenInfraPlatform {
 					// ************************************************************************************************************************	//
 					// TODO: IMPLEMENT OFFSETCURVE, PCURVE, SURFACECURVE
 					std::shared_ptr<typename IfcEntityTypesT::IfcOffsetCurve> offset_curve =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcOffsetCurve>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcOffsetCurve>(ifcCurve);
 					if (offset_curve) {
 						BLUE_LOG(warning) << offset_curve->getErrorLog() << ": Not supported";
 						return;
@@ -941,7 +942,7 @@ namespace OpenInfraPlatform {
 					//	IfcPcurve SUPTYPE of IfcCurve																							//
 					// ************************************************************************************************************************	//
 					std::shared_ptr<typename IfcEntityTypesT::IfcPcurve> p_curve =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPcurve>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcPcurve>(ifcCurve);
 					if (p_curve)
 					{
 						BLUE_LOG(warning) << p_curve->getErrorLog() << ": Not supported";
@@ -954,7 +955,7 @@ namespace OpenInfraPlatform {
 					//	ABSTRACT SUPERTYPE OF IfcIntersectionCurve, IfcSeamCurve																//
 					// ************************************************************************************************************************	//
 					std::shared_ptr<typename IfcEntityTypesT::IfcSurfaceCurve> surface_curve =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSurfaceCurve>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcSurfaceCurve>(ifcCurve);
 					if (surface_curve)
 					{
 						BLUE_LOG(warning) << surface_curve->getErrorLog() << ": Not supported";
@@ -1068,7 +1069,7 @@ namespace OpenInfraPlatform {
 					std::vector<carve::geom::vector<3>>& loop) const
 				{
 					const std::shared_ptr<typename IfcEntityTypesT::IfcPolyLoop> polyLoop =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyLoop>(ifcloop);
+						oip::entityCast<typename IfcEntityTypesT::IfcPolyLoop>(ifcloop);
 					if (polyLoop) 
 					{
 						std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcCartesianPoint>> ifcPoints;
@@ -1100,7 +1101,7 @@ namespace OpenInfraPlatform {
 					} // end if polyloop
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcEdgeLoop> edgeLoop =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcEdgeLoop>(ifcloop);
+						oip::entityCast<typename IfcEntityTypesT::IfcEdgeLoop>(ifcloop);
 					if (edgeLoop) 
 					{
 						std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcOrientedEdge>> edgeList;
@@ -1119,7 +1120,7 @@ namespace OpenInfraPlatform {
 							std::shared_ptr<typename IfcEntityTypesT::IfcEdge>& edgeElement = orientedEdge->EdgeElement.lock();
 
 							std::shared_ptr<typename IfcEntityTypesT::IfcEdgeCurve> edgeCurve =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcEdgeCurve>(edgeElement);
+								oip::entityCast<typename IfcEntityTypesT::IfcEdgeCurve>(edgeElement);
 
 							if (edgeCurve) {
 								std::shared_ptr<typename IfcEntityTypesT::IfcCurve>& curveGeom = edgeCurve->EdgeGeometry.lock();
@@ -1131,7 +1132,7 @@ namespace OpenInfraPlatform {
 							}
 
 							std::shared_ptr<typename IfcEntityTypesT::IfcSubedge> subEdge =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSubedge>(edgeElement);
+								oip::entityCast<typename IfcEntityTypesT::IfcSubedge>(edgeElement);
 
 							if (subEdge) {
 								std::cout << "ERROR\t| IfcSubedge not implemented" << std::endl;
@@ -1145,7 +1146,7 @@ namespace OpenInfraPlatform {
 							// every edge consists of one start and end vertex
 							std::shared_ptr<typename IfcEntityTypesT::IfcVertex>& edgeStartVertex = edgeElement->EdgeStart.lock();
 							std::shared_ptr<typename IfcEntityTypesT::IfcVertexPoint> edgeStartVertexPoint =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcVertexPoint>(edgeStartVertex);
+								oip::entityCast<typename IfcEntityTypesT::IfcVertexPoint>(edgeStartVertex);
 
 							if (edgeStartVertexPoint)
 							{
@@ -1154,7 +1155,7 @@ namespace OpenInfraPlatform {
 									std::shared_ptr<typename IfcEntityTypesT::IfcPoint>& startPoint =
 										edgeStartVertexPoint->VertexGeometry.lock();
 									std::shared_ptr<typename IfcEntityTypesT::IfcCartesianPoint> ifcPoint =
-										std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianPoint>(startPoint);
+										oip::entityCast<typename IfcEntityTypesT::IfcCartesianPoint>(startPoint);
 									if (!ifcPoint)
 									{
 										// TODO: could be also  IfcPointOnCurve, IfcPointOnSurface
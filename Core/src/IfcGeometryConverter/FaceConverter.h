@@ -36,6 +36,7 @@
 #include "UnhandledRepresentationException.h"
 
 #include "BlueFramework/Core/Diagnostics/log.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 
 namespace OpenInfraPlatform {
@@ -100,7 +101,7 @@ namespace OpenInfraPlatform {
 					//	ABSTRACT SUPERTYPE of IfcBSplineSurface, IfcCurveBoundedPlane, IfcCurveBoundedSurface, IfcRectangularTrimmedSurface		//
 					// ************************************************************************************************************************	//
 
-					std::shared_ptr<typename IfcEntityTypesT::IfcBoundedSurface> bounded_surface = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBoundedSurface>(surface);
+					std::shared_ptr<typename IfcEntityTypesT::IfcBoundedSurface> bounded_surface = oip::entityCast<typename IfcEntityTypesT::IfcBoundedSurface>(surface);
 
 					if(bounded_surface) {
 						if(convertIfcBSplineSurface(bounded_surface, pos, polyline_data)) {
@@ -109,7 +110,7 @@ namespace OpenInfraPlatform {
 
 						// (1/4) IfcBSplineSurface SUBTYPE of IfcBoundedSurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcBSplineSurface> bspline_surface =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBSplineSurface>(bounded_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcBSplineSurface>(bounded_surface);
 
 						if(bspline_surface) {
 							// Get attributes 1-4.
@@ -149,7 +150,7 @@ namespace OpenInfraPlatform {
 
 							// IfcBSplineSurfaceWithKnots SUBTYPE of IfcBSplineSurface
 							std::shared_ptr<typename IfcEntityTypesT::IfcBSplineSurface> bspline_knots = // bspline_surface zu bspline_knots
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBSplineSurface>(bounded_surface);
+								oip::entityCast<typename IfcEntityTypesT::IfcBSplineSurface>(bounded_surface);
 
 							if(bspline_knots) {
 								// Get attributes 8-12.
@@ -158,9 +159,9 @@ namespace OpenInfraPlatform {
 						}
 
 						// (2/4) IfcCurveBoundedPlane SUBTYPE OF IfcBoundedSurface.
-						if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCurveBoundedPlane>(bounded_surface)) {
+						if(oip::isOfType<typename IfcEntityTypesT::IfcCurveBoundedPlane>(bounded_surface)) {
 							std::shared_ptr<typename IfcEntityTypesT::IfcCurveBoundedPlane> curve_bounded_plane =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCurveBoundedPlane>(bounded_surface);
+								oip::entityCast<typename IfcEntityTypesT::IfcCurveBoundedPlane>(bounded_surface);
 
 							carve::math::Matrix curve_bounded_plane_matrix(pos);
 
@@ -200,7 +201,7 @@ namespace OpenInfraPlatform {
 
 						// (3/4) IfcCurveBoundedSurface SUBTYPE of IfcBoundedSurface.
 						std::shared_ptr<typename IfcEntityTypesT::IfcCurveBoundedSurface> curve_bounded_surface =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCurveBoundedSurface>(bounded_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcCurveBoundedSurface>(bounded_surface);
 
 						if(curve_bounded_surface) {
 							// Get basis surface, boundaries and implicit outer.
@@ -225,9 +226,9 @@ namespace OpenInfraPlatform {
 
 						}
 						// (4/4) IfcRectangularTrimmedSurface SUBTYPE of IfcBoundedSurface.
-						else if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRectangularTrimmedSurface>(bounded_surface)) {
+						else if(oip::isOfType<typename IfcEntityTypesT::IfcRectangularTrimmedSurface>(bounded_surface)) {
 							std::shared_ptr<typename IfcEntityTypesT::IfcRectangularTrimmedSurface> rectangular_trimmed_surface =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRectangularTrimmedSurface>(bounded_surface);
+								oip::entityCast<typename IfcEntityTypesT::IfcRectangularTrimmedSurface>(bounded_surface);
 							// Get attributes 1-7.
 							std::shared_ptr<typename IfcEntityTypesT::IfcSurface>& basis_surface = rectangular_trimmed_surface->BasisSurface.lock();
 							if(basis_surface) {
@@ -262,7 +263,7 @@ namespace OpenInfraPlatform {
 					// ************************************************************************************************************************	//
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcElementarySurface> elementary_surface =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcElementarySurface>(surface);
+						oip::entityCast<typename IfcEntityTypesT::IfcElementarySurface>(surface);
 
 					if(elementary_surface) {
 						// Get position.
@@ -276,7 +277,7 @@ namespace OpenInfraPlatform {
 
 						// (1/4) IfcCylindricalSurface SUBTYPE of IfcElementarySurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcCylindricalSurface> cylindrical_surface =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCylindricalSurface>(elementary_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcCylindricalSurface>(elementary_surface);
 
 						if(cylindrical_surface) {
 							// Get radius.
@@ -288,7 +289,7 @@ namespace OpenInfraPlatform {
 
 						// (2/4) IfcPlane SUBTYPE of IfcElementarySurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcPlane> elementary_surface_plane =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPlane>(elementary_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcPlane>(elementary_surface);
 
 						if(elementary_surface_plane) {
 							//  1----0     create big rectangular plane
@@ -313,7 +314,7 @@ namespace OpenInfraPlatform {
 
 						// (3/4) IfcSphericalPlane SUBTYPE of IfcElementarySurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcSphericalSurface> spherical_surface =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSphericalSurface>(elementary_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcSphericalSurface>(elementary_surface);
 
 						if(spherical_surface) {
 							// Get radius.
@@ -327,7 +328,7 @@ namespace OpenInfraPlatform {
 
 						// (4/4) IfcToroidalSurface SUBTYPE of IfcElementarySurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcToroidalSurface> toroidal_surface =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcToroidalSurface>(elementary_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcToroidalSurface>(elementary_surface);
 
 						if(toroidal_surface) {
 							// Get major and minor radius.
@@ -350,8 +351,8 @@ namespace OpenInfraPlatform {
 					//	ABSTRACT SUPERTYPE of IfcSurfaceOfLinearExtrusion, IfcSurfaceOfRevolution												//
 					// ************************************************************************************************************************	//
 
-					std::shared_ptr<typename IfcEntityTypesT::IfcSweptSurface> swept_surface = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSweptSurface>(surface);
-					if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSweptSurface>(surface)) {
+					std::shared_ptr<typename IfcEntityTypesT::IfcSweptSurface> swept_surface = oip::entityCast<typename IfcEntityTypesT::IfcSweptSurface>(surface);
+					if(oip::isOfType<typename IfcEntityTypesT::IfcSweptSurface>(surface)) {
 						// Get swept curve and position.
 						std::shared_ptr<typename IfcEntityTypesT::IfcProfileDef>& swept_surface_profile = swept_surface->SweptCurve.lock();
 						std::shared_ptr<typename IfcEntityTypesT::IfcAxis2Placement3D> swept_surface_placement = nullptr;
@@ -371,7 +372,7 @@ namespace OpenInfraPlatform {
 
 						// (1/2) IfcSurfaceOfLinearExtrusion SUBTYPE of IfcSweptSurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcSurfaceOfLinearExtrusion> linear_extrusion =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSurfaceOfLinearExtrusion>(swept_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcSurfaceOfLinearExtrusion>(swept_surface);
 
 						if(linear_extrusion) {
 							// Get extrude direction and depth.
@@ -387,7 +388,7 @@ namespace OpenInfraPlatform {
 
 						// (2/2) IfcSurfaceOfRevolution SUBTYPE of IfcSweptSurface
 						std::shared_ptr<typename IfcEntityTypesT::IfcSurfaceOfRevolution> surface_of_revolution =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSurfaceOfRevolution>(swept_surface);
+							oip::entityCast<typename IfcEntityTypesT::IfcSurfaceOfRevolution>(swept_surface);
 
 						if(surface_of_revolution) {
 							// Get axis position.
@@ -482,7 +483,7 @@ namespace OpenInfraPlatform {
 					for(auto it = bounds.cbegin(); it != bounds.cend(); ++it) {
 						std::shared_ptr<typename IfcEntityTypesT::IfcFaceBound> bound = *it;
 
-						std::shared_ptr<typename IfcEntityTypesT::IfcFaceOuterBound> outerBound = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcFaceOuterBound>(bound);
+						std::shared_ptr<typename IfcEntityTypesT::IfcFaceOuterBound> outerBound = oip::entityCast<typename IfcEntityTypesT::IfcFaceOuterBound>(bound);
 
 						if(outerBound) {
 							modBounds.insert(modBounds.begin(), outerBound);
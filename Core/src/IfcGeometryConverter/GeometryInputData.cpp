@@ -41,4 +41,40 @@ void ItemData::createMeshSetsFromClosedPolyhedrons()
 	}
 
 	closed_polyhedrons.clear();
-}
\ No newline at end of file
+}
+
+namespace
+{
+	template<typename T>
+	void copyTransformed( const std::vector<std::shared_ptr<T>>& source, std::vector<std::shared_ptr<T>>& target, const carve::math::Matrix& matrix )
+	{
+		for( const auto& data : source )
+		{
+			std::shared_ptr<T> copy = std::make_shared<T>( *data );
+			copy->transform( matrix );
+			target.push_back( copy );
+		}
+	}
+}
+
+void ItemData::copyPrototypeGeometry()
+{
+	if( !prototype )
+	{
+		return;
+	}
+
+	copyTransformed( prototype->closed_polyhedrons, closed_polyhedrons, prototype_transform );
+	copyTransformed( prototype->open_polyhedrons, open_polyhedrons, prototype_transform );
+	copyTransformed( prototype->open_or_closed_polyhedrons, open_or_closed_polyhedrons, prototype_transform );
+	copyTransformed( prototype->polylines, polylines, prototype_transform );
+
+	for( const auto& meshset : prototype->meshsets )
+	{
+		std::shared_ptr<carve::mesh::MeshSet<3>> meshset_copy( meshset->clone() );
+		meshset_copy->transform( carve::math::matrix_transformation( prototype_transform ) );
+		meshsets.push_back( meshset_copy );
+	}
+
+	prototype.reset();
+}
@@ -54,6 +54,13 @@ namespace OpenInfraPlatform {
 				std::vector<std::shared_ptr<carve::input::PolylineSetData>> polylines;
 				std::vector<std::shared_ptr<carve::mesh::MeshSet<3>>>		meshsets;
 				void createMeshSetsFromClosedPolyhedrons();
+
+				// replaces the reference to the prototype by a copy of its geometry transformed by prototype_transform, e.g. before openings are subtracted
+				void copyPrototypeGeometry();
+
+				// set for items of an IfcMappedItem, they hold no geometry of their own but draw the prototype transformed by prototype_transform
+				std::shared_ptr<const ItemData>								prototype;
+				carve::math::Matrix											prototype_transform;
 			};
 
 			/**************************************************************************************/
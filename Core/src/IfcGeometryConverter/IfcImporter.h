@@ -24,9 +24,13 @@
 #include <mutex>
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
 #include <boost/algorithm/string.hpp>
 
 #include "CarveHeaders.h"
+#include "ConversionScheduler.h"
 #include "RepresentationConverter.h"
 #include "UnitConverter.h"
 
@@ -150,7 +154,7 @@ namespace OpenInfraPlatform
 
 					// check if the product is an ifcElement, if so, it may contain opening data
 					std::shared_ptr<typename IfcEntityTypesT::IfcElement> element =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcElement>(entity);
+						oip::entityCast<typename IfcEntityTypesT::IfcElement>(entity);
 
 					if(element) {
 						// then collect opening data
@@ -221,14 +225,17 @@ namespace OpenInfraPlatform
 					{
 						BLUE_LOG(info) << "Importing geometry from express model.";
 
-						auto project = std::find_if(model->entities.begin(), model->entities.end(), [](auto pair) { return boost::algorithm::to_upper_copy(pair.second->classname())  == "IFCPROJECT"; });
+						// the extents of the model hold the ids of all entities by type, the types of the entities are known
+						auto projects = model->extents.of("IfcProject");
 
-						if(project != model->entities.end()) {
+						if(!projects.empty()) {
 
 							// Set the unit conversion factors
 							std::shared_ptr<typename IfcEntityTypesT::IfcProject> ifcproject =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcProject>(project->second);
+								std::static_pointer_cast<typename IfcEntityTypesT::IfcProject>(model->entities.get(*projects.begin()));
+							ifcproject->decode();
 							unitConverter->setIfcProject(ifcproject);
+							repConverter->setModel(model);
 
 							//std::for_each(model->entities.begin(), model->entities.end(), [this, &model](std::pair<size_t, std::shared_ptr<oip::EXPRESSEntity>> &pair) {
 							//	std::shared_ptr<typename IfcEntityTypesT::IfcProduct> product = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcProduct>(pair.second);
@@ -240,25 +247,84 @@ namespace OpenInfraPlatform
 							//		shapeInputData.insert(std::make_pair<int, std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>(pair.first, productShape));
 							//	}
 							//});
-							try {
-								for (auto& pair : model->entities) {
-									std::shared_ptr<typename IfcEntityTypesT::IfcProduct> product = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcProduct>(pair.second);
-									if (product) {
+							// the extent of an abstract type holds the ids of each subtype in turn, sorting them and storing the shapes
+							// by their position makes the result independent of the threads
+							auto products = model->extents.of("IfcProduct");
+							std::vector<size_t> productIds(products.begin(), products.end());
+							std::sort(productIds.begin(), productIds.end());
+							std::vector<std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>> productShapes(productIds.size());
+
+							// the conversion time of the products differs by orders of magnitude, the expensive ones are started first
+							// and idle threads take the next unconverted product, so a few expensive products do not hold up the others
+							std::atomic<bool> failed(false);
+							std::mutex errorMutex;
+							std::string error;
+							auto reportError = [&](size_t i, const std::string& message) {
+								std::lock_guard<std::mutex> lock(errorMutex);
+								if (!failed.exchange(true))
+									error = "IfcProduct #" + std::to_string(productIds[i]) + ": " + message;
+							};
+
+							// carve::exception is not derived from std::exception, nothing may escape the worker threads
+							std::vector<double> costs(productIds.size());
+							const ConversionCostT<IfcEntityTypesT> conversionCost(model);
+							std::vector<size_t> order(productIds.size());
+							std::iota(order.begin(), order.end(), 0);
+							ConversionScheduler::run(order, [&](size_t i, unsigned int) {
+								if (failed) {
+									return;
+								}
+								try {
+									std::shared_ptr<typename IfcEntityTypesT::IfcProduct> product = std::static_pointer_cast<typename IfcEntityTypesT::IfcProduct>(model->entities.get(productIds[i]));
+									product->decode();
+									costs[i] = conversionCost.estimate(product);
+								}
+								catch (const std::exception& e) {
+									reportError(i, e.what());
+								}
+								catch (const carve::exception& e) {
+									reportError(i, e.str());
+								}
+								catch (...) {
+									reportError(i, "unknown exception");
+								}
+							});
+
+							ConversionScheduler::run(ConversionScheduler::orderByCost(costs), [&](size_t i, unsigned int) {
+								if (failed) {
+									return;
+								}
+								try {
+									std::shared_ptr<typename IfcEntityTypesT::IfcProduct> product = std::static_pointer_cast<typename IfcEntityTypesT::IfcProduct>(model->entities.get(productIds[i]));
+									product->decode();
 #ifdef _DEBUG
-										BLUE_LOG(trace) << "Converting IfcProduct #" << product->getId();
+									BLUE_LOG(trace) << "Converting IfcProduct #" << product->getId();
 #endif
-										// create new shape input data for product
-										std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>> productShape = std::make_shared<ShapeInputDataT<IfcEntityTypesT>>();
-										productShape->ifc_product = product;
-										IfcImporterUtil::convertIfcProduct<IfcEntityTypesT>(product, productShape, repConverter);
-										shapeInputData.insert(std::pair<int, std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>>(pair.first, productShape));
-									}
+									// create new shape input data for product
+									std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>> productShape = std::make_shared<ShapeInputDataT<IfcEntityTypesT>>();
+									productShape->ifc_product = product;
+									IfcImporterUtil::convertIfcProduct<IfcEntityTypesT>(product, productShape, repConverter);
+									productShapes[i] = productShape;
 								}
-							}
-							catch (std::exception e) {
-								BLUE_LOG(warning) << "Failed collecting geometry data. Abort. " << e.what();
+								catch (const std::exception& e) {
+									reportError(i, e.what());
+								}
+								catch (const carve::exception& e) {
+									reportError(i, e.str());
+								}
+								catch (...) {
+									reportError(i, "unknown exception");
+								}
+							});
+
+							if (failed) {
+								BLUE_LOG(warning) << "Failed collecting geometry data. Abort. " << error;
 								return false;
 							}
+
+							for (size_t i = 0; i < productIds.size(); i++) {
+								shapeInputData.insert(std::pair<int, std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>>(productIds[i], productShapes[i]));
+							}
 						}
 						else {
 							BLUE_LOG(warning) << "No IfcProject found in model.";
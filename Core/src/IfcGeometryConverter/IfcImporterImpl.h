@@ -108,11 +108,11 @@ static void OpenInfraPlatform::Core::IfcGeometryConverter::IfcImporterUtil::conv
 #endif
 	}
 
-	if (std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment>(product)) {
-		auto alignment = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment>(product);
+	if (oip::isOfType<typename IfcEntityTypesT::IfcAlignment>(product)) {
+		auto alignment = oip::entityCast<typename IfcEntityTypesT::IfcAlignment>(product);
 		std::shared_ptr<ItemData> itemData(new ItemData());
 		productShape->vec_item_data.push_back(itemData);
-		std::shared_ptr<typename IfcEntityTypesT::IfcGeometricRepresentationItem> axis = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGeometricRepresentationItem>(alignment->Axis.lock());
+		std::shared_ptr<typename IfcEntityTypesT::IfcGeometricRepresentationItem> axis = oip::entityCast<typename IfcEntityTypesT::IfcGeometricRepresentationItem>(alignment->Axis.lock());
 		repConverter->convertIfcGeometricRepresentationItem(axis, carve::math::Matrix::IDENT(), itemData, strerr);
 	}
 
@@ -27,6 +27,7 @@
 #include "CarveHeaders.h"
 
 #include "ConverterBase.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 #include <BlueFramework/Core/Diagnostics/log.h>
 
@@ -185,14 +186,14 @@ namespace OpenInfraPlatform {
 					// **************************************************************************************************************************
 
 					// (1/3) IfcAxis1Placement SUBTYPE OF IfcPlacement
-					if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAxis1Placement>(placement)) {
+					if(oip::isOfType<typename IfcEntityTypesT::IfcAxis1Placement>(placement)) {
 						BLUE_LOG(error) << placement->getErrorLog() << ": Not implemented.";
 						return;
 					}
 
 					// (2/3) IfcAxis2Placement2D SUBTYPE OF IfcPlacement 
 					std::shared_ptr<typename IfcEntityTypesT::IfcAxis2Placement2D>& axis2placement2d =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAxis2Placement2D>(placement);
+						oip::entityCast<typename IfcEntityTypesT::IfcAxis2Placement2D>(placement);
 					if( axis2placement2d ) {
 						convertIfcAxis2Placement2D(axis2placement2d, matrix);
 						return;
@@ -200,7 +201,7 @@ namespace OpenInfraPlatform {
 
 					// (3/3) IfcAxis2Placement3D SUBTYPE OF IfcPlacement
 					std::shared_ptr<typename IfcEntityTypesT::IfcAxis2Placement3D>& axis2placement3d = 
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAxis2Placement3D>(placement);
+						oip::entityCast<typename IfcEntityTypesT::IfcAxis2Placement3D>(placement);
 					if( axis2placement3d ) {
 						convertIfcAxis2Placement3D(axis2placement3d, matrix);
 						return; 
@@ -378,7 +379,7 @@ namespace OpenInfraPlatform {
 
 					// (1/3) IfcLocalPLacement SUBTYPE OF IfcObjectPlacement
 					std::shared_ptr<typename IfcEntityTypesT::IfcLocalPlacement> local_placement =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcLocalPlacement>(objectPlacement);
+						oip::entityCast<typename IfcEntityTypesT::IfcLocalPlacement>(objectPlacement);
 					if(local_placement) {
 						// **************************************************************************************************************************
 						//  https://standards.buildingsmart.org/IFC/RELEASE/IFC4_1/FINAL/HTML/link/ifclocalplacement.htm
@@ -430,7 +431,7 @@ namespace OpenInfraPlatform {
 
 					// (2/3) IfcGridPlacement SUBTYPE OF IfcObjectPlacement
 					std::shared_ptr<typename IfcEntityTypesT::IfcGridPlacement> grid_placement =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGridPlacement>(objectPlacement);
+						oip::entityCast<typename IfcEntityTypesT::IfcGridPlacement>(objectPlacement);
 					if( grid_placement ) {
 						//TODO Not implemented
 						BLUE_LOG(warning) << grid_placement->getErrorLog() << ": Not implemented";
@@ -438,7 +439,7 @@ namespace OpenInfraPlatform {
 
 					// (3/3) IfcLinearPlacement SUBTYPE OF IfcObjectPlacement
 					std::shared_ptr<typename IfcEntityTypesT::IfcLinearPlacement > linear_placement =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcLinearPlacement>(objectPlacement);
+						oip::entityCast<typename IfcEntityTypesT::IfcLinearPlacement>(objectPlacement);
 					if (linear_placement) {
 						// **************************************************************************************************************************
 						//  https://standards.buildingsmart.org/IFC/RELEASE/IFC4_1/FINAL/HTML/link/ifclinearplacement.htm
@@ -456,7 +457,7 @@ namespace OpenInfraPlatform {
 						std::shared_ptr<typename IfcEntityTypesT::IfcCurve> ifcCurve = GetCurveOfPlacement(linear_placement);
 
 						std::shared_ptr<typename IfcEntityTypesT::IfcBoundedCurve> ifcBoundedCurve =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBoundedCurve>(ifcCurve);
+							oip::entityCast<typename IfcEntityTypesT::IfcBoundedCurve>(ifcCurve);
 						if (!ifcBoundedCurve)
 						{
 							BLUE_LOG(error) << linear_placement->getErrorLog() << ": Linear placement along a " << ifcCurve->classname() << " is not supported!";
@@ -595,7 +596,7 @@ namespace OpenInfraPlatform {
 					}
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcGeometricRepresentationContext> geom_context =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGeometricRepresentationContext>(context);
+						oip::entityCast<typename IfcEntityTypesT::IfcGeometricRepresentationContext>(context);
 					if(!geom_context) {
 						return;
 					}
@@ -619,7 +620,7 @@ namespace OpenInfraPlatform {
 					// Inverse attributes: std::vector<weak_ptr<IfcGeometricRepresentationSubContext> >	HasSubContexts_inverse;
 
 					carve::math::Matrix world_coords_matrix(carve::math::Matrix::IDENT());
-					std::shared_ptr<typename IfcEntityTypesT::IfcAxis2Placement3D> world_coords_3d = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAxis2Placement3D>(world_coords);
+					std::shared_ptr<typename IfcEntityTypesT::IfcAxis2Placement3D> world_coords_3d = oip::entityCast<typename IfcEntityTypesT::IfcAxis2Placement3D>(world_coords);
 					if(world_coords_3d) {
 						PlacementConverterT<IfcEntityTypesT>::convertIfcAxis2Placement3D(world_coords_3d, world_coords_matrix, length_factor);
 					}
@@ -628,7 +629,7 @@ namespace OpenInfraPlatform {
 
 					// Get inverse attribute.
 					std::shared_ptr<typename IfcEntityTypesT::IfcGeometricRepresentationSubContext> geom_sub_context =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGeometricRepresentationSubContext>(geom_context);
+						oip::entityCast<typename IfcEntityTypesT::IfcGeometricRepresentationSubContext>(geom_context);
 					if(geom_sub_context) {
 						// Get attributes.
 						// ParentContext type IfcGeometricRepresentationContext, TargetScale type IfcPositiveRatioMeasure [OPTIONAL], TargetView type IfcGeometricProjectionEnum, UserDefinedTargetView type IfcLabel [OPTIONAL]
@@ -660,9 +661,9 @@ namespace OpenInfraPlatform {
 					double scale_z = 1.0;
 
 					// (1/2) IfcCartesianTransformationOperator2D SUBTYPE OF IfcCartesianTranformationOperator
-					if(std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianTransformationOperator2D>(transform_operator)) {
+					if(oip::isOfType<typename IfcEntityTypesT::IfcCartesianTransformationOperator2D>(transform_operator)) {
 						std::shared_ptr<typename IfcEntityTypesT::IfcCartesianTransformationOperator2D> trans_operator_2d =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianTransformationOperator2D>(transform_operator);
+							oip::entityCast<typename IfcEntityTypesT::IfcCartesianTransformationOperator2D>(transform_operator);
 
 						if(!trans_operator_2d->LocalOrigin) {
 							std::stringstream ss;
@@ -712,7 +713,7 @@ namespace OpenInfraPlatform {
 						}
 
 						// IfcCartesianTransformationOperator2DnonUniform SUBTYPE OF IfcCartesianTransformationOperator2D
-						std::shared_ptr<typename IfcEntityTypesT::IfcCartesianTransformationOperator2DnonUniform> non_uniform = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianTransformationOperator2DnonUniform>(transform_operator);
+						std::shared_ptr<typename IfcEntityTypesT::IfcCartesianTransformationOperator2DnonUniform> non_uniform = oip::entityCast<typename IfcEntityTypesT::IfcCartesianTransformationOperator2DnonUniform>(transform_operator);
 						if(non_uniform) {
 							if(non_uniform->Scale2 == non_uniform->Scale2) {
 								// Scale2 is not NAN
@@ -724,7 +725,7 @@ namespace OpenInfraPlatform {
 					// (2/2) IfcCartesianTransformationOperator3D SUBTYPE OF IfcCartesianTranformationOperator
 					else {
 						std::shared_ptr<typename IfcEntityTypesT::IfcCartesianTransformationOperator3D> trans_operator_3d =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianTransformationOperator3D>(transform_operator);
+							oip::entityCast<typename IfcEntityTypesT::IfcCartesianTransformationOperator3D>(transform_operator);
 
 						if(!trans_operator_3d) {
 							std::stringstream ss;
@@ -789,7 +790,7 @@ namespace OpenInfraPlatform {
 
 						// IfcCartesianTransformationOperator3DnonUniform SUBTYPE OF IfcCartesianTransformationOperator3D
 						std::shared_ptr<typename IfcEntityTypesT::IfcCartesianTransformationOperator3DnonUniform> non_uniform =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianTransformationOperator3DnonUniform>(transform_operator);
+							oip::entityCast<typename IfcEntityTypesT::IfcCartesianTransformationOperator3DnonUniform>(transform_operator);
 
 						if(non_uniform) {
 							if(non_uniform->Scale2 == non_uniform->Scale2) {
@@ -898,7 +899,7 @@ namespace OpenInfraPlatform {
 					double plane_angle_factor = UnitConvert()->getAngleInRadianFactor();
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcAlignmentCurve> alignment_curve =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignmentCurve>(ifcCurve);
+						oip::entityCast<typename IfcEntityTypesT::IfcAlignmentCurve>(ifcCurve);
 					if (alignment_curve)
 					{
 						// **************************************************************************************************************************
@@ -1102,11 +1103,11 @@ namespace OpenInfraPlatform {
 
 						// types have additional data -> calculate the exact position within the segment
 						std::shared_ptr<typename IfcEntityTypesT::IfcLineSegment2D> line_segment_2D =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcLineSegment2D>(horCurveGeometryRelevantToPoint);
+							oip::entityCast<typename IfcEntityTypesT::IfcLineSegment2D>(horCurveGeometryRelevantToPoint);
 						std::shared_ptr<typename IfcEntityTypesT::IfcCircularArcSegment2D> circular_arc_segment_2D =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCircularArcSegment2D>(horCurveGeometryRelevantToPoint);
+							oip::entityCast<typename IfcEntityTypesT::IfcCircularArcSegment2D>(horCurveGeometryRelevantToPoint);
 						std::shared_ptr<typename IfcEntityTypesT::IfcTransitionCurveSegment2D> trans_curve_segment_2D =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTransitionCurveSegment2D>(horCurveGeometryRelevantToPoint);
+							oip::entityCast<typename IfcEntityTypesT::IfcTransitionCurveSegment2D>(horCurveGeometryRelevantToPoint);
 						
 						//********************************************************************
 						// 4.a determine the functions
@@ -1535,11 +1536,11 @@ namespace OpenInfraPlatform {
 						if ( verticalSegmentRelevantToPoint )
 						{
 							const std::shared_ptr<typename IfcEntityTypesT::IfcAlignment2DVerSegLine>& v_seg_line_2D =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment2DVerSegLine>(verticalSegmentRelevantToPoint);
+								oip::entityCast<typename IfcEntityTypesT::IfcAlignment2DVerSegLine>(verticalSegmentRelevantToPoint);
 							const std::shared_ptr<typename IfcEntityTypesT::IfcAlignment2DVerSegCircularArc>& v_seg_circ_arc_2D =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment2DVerSegCircularArc>(verticalSegmentRelevantToPoint);
+								oip::entityCast<typename IfcEntityTypesT::IfcAlignment2DVerSegCircularArc>(verticalSegmentRelevantToPoint);
 							const std::shared_ptr<typename IfcEntityTypesT::IfcAlignment2DVerSegParabolicArc>& v_seg_par_arc_2D =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAlignment2DVerSegParabolicArc>(verticalSegmentRelevantToPoint);
+								oip::entityCast<typename IfcEntityTypesT::IfcAlignment2DVerSegParabolicArc>(verticalSegmentRelevantToPoint);
 
 							// common parameters
 							// StartDistAlong type IfcLengthMeasure [1:1]
@@ -21,8 +21,12 @@
 #ifndef PROFILECACHE_H
 #define PROFILECACHE_H
 
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <tuple>
 
 #include "CarveHeaders.h"
 
@@ -61,15 +65,7 @@ namespace OpenInfraPlatform {
 #ifdef _DEBUG
 						BLUE_LOG(trace) << "Getting ProfileConverterT for IfcProfileDef #" << profile_id;
 #endif
-						typename std::map<int, std::shared_ptr<ProfileConverterT<IfcEntityTypesT>>>::iterator
-							it_profile_cache = profileCache.find(profile_id);
-						if(it_profile_cache != profileCache.end()) {
-#ifdef _DEBUG
-							BLUE_LOG(trace) << "Found ProfileConverterT for IfcProfileDef #" << profile_id;
-#endif
-							return it_profile_cache->second;
-						}
-						else {
+						return getOrCompute(profileCache, profile_id, [&]() {
 #ifdef _DEBUG
 							BLUE_LOG(trace) << "Creating ProfileConverterT for IfcProfile #" << profile_id;
 #endif
@@ -77,25 +73,77 @@ namespace OpenInfraPlatform {
 								std::make_shared<ProfileConverterT<IfcEntityTypesT>>(GeomSettings(), UnitConvert(), placementConverter);
 
 							profile_converter->computeProfile(ifcProfile);
-
-							profileCache[profile_id] = profile_converter;
-
-#ifdef _DEBUG
-							BLUE_LOG(trace) << "Created ProfileConverterT for IfcProfile #" << profile_id;
-#endif
 							return profile_converter;
-						}
+						});
+					}
+
+					// Extrusion of the profile along depth * direction in the coordinate system of the profile, shared by all
+					// IfcExtrudedAreaSolids with the same profile, depth and direction. Empty if the profile has no paths.
+					std::shared_ptr<const carve::input::PolyhedronData> getExtrusion(
+						std::shared_ptr<typename IfcEntityTypesT::IfcProfileDef>& ifcProfile,
+						const double depth,
+						const carve::geom::vector<3>& direction,
+						std::stringstream& err)
+					{
+						const ExtrusionKey key(ifcProfile->getId(), depth, direction.x, direction.y, direction.z);
+						return getOrCompute(extrusionCache, key, [&]() {
+							// the cached profile is shared by all threads, so the paths are simplified on a copy
+							std::vector<std::vector<carve::geom::vector<2>>> paths = getProfileConverter(ifcProfile)->getCoordinates();
+							ProfileConverterT<IfcEntityTypesT>::simplifyPaths(paths);
+
+							std::shared_ptr<carve::input::PolyhedronData> poly_data;
+							if(!paths.empty()) {
+								poly_data = std::make_shared<carve::input::PolyhedronData>();
+								GeomUtils::extrude(paths, direction * depth, poly_data, err);
+							}
+							return std::shared_ptr<const carve::input::PolyhedronData>(poly_data);
+						});
 					}
 
 					void clearProfileCache()
 					{
+						std::lock_guard<std::mutex> lock(profileCacheMutex);
 						profileCache.clear();
+						extrusionCache.clear();
 					}
 
 				protected:
 
+					typedef std::tuple<int, double, double, double, double> ExtrusionKey;
+
+					// Returns the cached value or computes it outside of the lock. Threads asking for a value that is being
+					// computed wait for it instead of computing it again, threads asking for other values do not wait.
+					template <typename Key, typename Value, typename Compute>
+					Value getOrCompute(std::map<Key, std::shared_future<Value>>& cache, const Key& key, const Compute& compute)
+					{
+						std::promise<Value> promise;
+						std::shared_future<Value> future;
+						bool computing = false;
+						{
+							std::lock_guard<std::mutex> lock(profileCacheMutex);
+							auto it_cache = cache.find(key);
+							if(it_cache == cache.end()) {
+								it_cache = cache.insert(std::make_pair(key, promise.get_future().share())).first;
+								computing = true;
+							}
+							future = it_cache->second;
+						}
+
+						if(computing) {
+							try {
+								promise.set_value(compute());
+							}
+							catch(...) {
+								promise.set_exception(std::current_exception());
+							}
+						}
+						return future.get();
+					}
+
 					std::shared_ptr<PlacementConverterT<IfcEntityTypesT>> placementConverter;
-					std::map<int, std::shared_ptr<ProfileConverterT<IfcEntityTypesT>>> profileCache;
+					std::map<int, std::shared_future<std::shared_ptr<ProfileConverterT<IfcEntityTypesT>>>> profileCache;
+					std::map<ExtrusionKey, std::shared_future<std::shared_ptr<const carve::input::PolyhedronData>>> extrusionCache;
+					std::mutex profileCacheMutex;
 			};
 		}
 	}
@@ -31,6 +31,7 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include "PlacementConverter.h"
 
 #include "BlueFramework/Core/Diagnostics/log.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 
 /**********************************************************************************************/
@@ -71,7 +72,7 @@ namespace OpenInfraPlatform {
 #endif
 				// (1/5) IfcArbitraryClosedProfileDef SUBTYPE OF IfcProfileDef
 				std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef> arbitrary_closed =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(profileDef);
+					oip::entityCast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(profileDef);
 				if(arbitrary_closed) {
 					convertIfcArbitraryClosedProfileDef(arbitrary_closed, paths);
 					removeDuplicates(paths);
@@ -80,7 +81,7 @@ namespace OpenInfraPlatform {
 
 				// (2/5) IfcArbitraryOpenProfileDef SUBTYPE OF IfcProfileDef
 				std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef> arbitrary_open =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef>(profileDef);
+					oip::entityCast<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef>(profileDef);
 				if(arbitrary_open) {
 					convertIfcArbitraryOpenProfileDef(arbitrary_open, paths);
 					removeDuplicates(paths);
@@ -88,7 +89,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (3/5) IfcCompositeProfileDef SUBTYPE OF IfcProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcCompositeProfileDef> composite = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCompositeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcCompositeProfileDef> composite = oip::entityCast<typename IfcEntityTypesT::IfcCompositeProfileDef>(profileDef);
 				if(composite) {
 					convertIfcCompositeProfileDef(composite, paths);
 					removeDuplicates(paths);
@@ -96,7 +97,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (4/5) IfcDerivedProfileDef SUBTYPE OF IfcProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcDerivedProfileDef> derived = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcDerivedProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcDerivedProfileDef> derived = oip::entityCast<typename IfcEntityTypesT::IfcDerivedProfileDef>(profileDef);
 				if(derived) {
 					convertIfcDerivedProfileDef(derived, paths);
 					removeDuplicates(paths);
@@ -105,7 +106,7 @@ namespace OpenInfraPlatform {
 
 				// (5/5) IfcParameterizedProfileDef SUBTYPE OF IfcProfileDef
 				std::shared_ptr<typename IfcEntityTypesT::IfcParameterizedProfileDef> parameterized =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcParameterizedProfileDef>(profileDef);
+					oip::entityCast<typename IfcEntityTypesT::IfcParameterizedProfileDef>(profileDef);
 				if(parameterized) {
 					convertIfcParameterizedProfileDefWithPosition(parameterized, paths);
 					removeDuplicates(paths);
@@ -155,7 +156,7 @@ namespace OpenInfraPlatform {
 
 				// IfcArbitraryProfileDefWithVoids
 				std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryProfileDefWithVoids> profile_with_voids =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryProfileDefWithVoids>(profileDef);
+					oip::entityCast<typename IfcEntityTypesT::IfcArbitraryProfileDefWithVoids>(profileDef);
 				if(profile_with_voids) {
 #ifdef _DEBUG
 					BLUE_LOG(trace) << "Processing IfcArbitraryProfileDefWithVoids #" << profile_with_voids->getId();
@@ -192,11 +193,11 @@ namespace OpenInfraPlatform {
 				const double lengthFactor = UnitConvert()->getLengthInMeterFactor();
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcCurve> outer_curve = profile->OuterCurve;
-				std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> polyline = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyline>(outer_curve);
+				std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> polyline = oip::entityCast<typename IfcEntityTypesT::IfcPolyline>(outer_curve);
 
 				if(polyline) {
 					std::shared_ptr<typename IfcEntityTypesT::IfcCurve> next_outer_curve = next_profile->OuterCurve;
-					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> next_polyline = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyline>(next_outer_curve);
+					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> next_polyline = oip::entityCast<typename IfcEntityTypesT::IfcPolyline>(next_outer_curve);
 
 					// describe 2D-polyline geometry
 					std::shared_ptr<carve::input::PolylineSetData> polylineData(new carve::input::PolylineSetData());
@@ -321,7 +322,7 @@ namespace OpenInfraPlatform {
 				CurveConverterT<IfcEntityTypesT> c_converter(GeomSettings(), UnitConvert(), placementConverter);
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcCenterLineProfileDef> center_line_profile_def =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCenterLineProfileDef>(profileDef);
+					oip::entityCast<typename IfcEntityTypesT::IfcCenterLineProfileDef>(profileDef);
 				if(center_line_profile_def) {
 					if(center_line_profile_def->Thickness) {
 						const double thickness = center_line_profile_def->Thickness * UnitConvert()->getLengthInMeterFactor();
@@ -426,32 +427,32 @@ namespace OpenInfraPlatform {
 					//std::shared_ptr<typename IfcEntityTypesT::IfcProfileDef> profileDef = it;
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcParameterizedProfileDef> parameterized =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcParameterizedProfileDef>(profileDef);
+						oip::entityCast<typename IfcEntityTypesT::IfcParameterizedProfileDef>(profileDef);
 					if(parameterized) {
 						convertIfcParameterizedProfileDefWithPosition(parameterized, paths);
 						continue;
 					}
 
-					std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef> open = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef>(profileDef);
+					std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef> open = oip::entityCast<typename IfcEntityTypesT::IfcArbitraryOpenProfileDef>(profileDef);
 					if(open) {
 						convertIfcArbitraryOpenProfileDef(open, paths);
 						continue;
 					}
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef> closed =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(profileDef);
+						oip::entityCast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(profileDef);
 					if(closed) {
 						convertIfcArbitraryClosedProfileDef(closed, paths);
 						continue;
 					}
 
-					std::shared_ptr<typename IfcEntityTypesT::IfcCompositeProfileDef> composite = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCompositeProfileDef>(profileDef);
+					std::shared_ptr<typename IfcEntityTypesT::IfcCompositeProfileDef> composite = oip::entityCast<typename IfcEntityTypesT::IfcCompositeProfileDef>(profileDef);
 					if(composite) {
 						convertIfcCompositeProfileDef(composite, paths);
 						continue;
 					}
 
-					std::shared_ptr<typename IfcEntityTypesT::IfcDerivedProfileDef> derived = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcDerivedProfileDef>(profileDef);
+					std::shared_ptr<typename IfcEntityTypesT::IfcDerivedProfileDef> derived = oip::entityCast<typename IfcEntityTypesT::IfcDerivedProfileDef>(profileDef);
 					if(derived) {
 						convertIfcDerivedProfileDef(derived, paths);
 						continue;
@@ -517,7 +518,7 @@ namespace OpenInfraPlatform {
 				std::vector<carve::geom::vector<2>> outer_loop;
 
 				// (1/10) IfcRectangleProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcRectangleProfileDef> rectangle_profile = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRectangleProfileDef>(profileDef);		
+				std::shared_ptr<typename IfcEntityTypesT::IfcRectangleProfileDef> rectangle_profile = oip::entityCast<typename IfcEntityTypesT::IfcRectangleProfileDef>(profileDef);		
 				if(rectangle_profile) {
 
 					if(rectangle_profile->XDim && rectangle_profile->YDim) {
@@ -526,7 +527,7 @@ namespace OpenInfraPlatform {
 
 						// IfcRectangleHollowProfileDef SUBTYPE OF IfcRectangleProfile 
 						std::shared_ptr<typename IfcEntityTypesT::IfcRectangleHollowProfileDef> hollow =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRectangleHollowProfileDef>(rectangle_profile);
+							oip::entityCast<typename IfcEntityTypesT::IfcRectangleHollowProfileDef>(rectangle_profile);
 						if(hollow) {
 							if(hollow->WallThickness) {
 								double t = hollow->WallThickness * length_factor;
@@ -578,7 +579,7 @@ namespace OpenInfraPlatform {
 
 						// IfcRoundedRectangleProfileDef SUBTYPE OF IfcRectangleProfile 
 						std::shared_ptr<typename IfcEntityTypesT::IfcRoundedRectangleProfileDef> rounded_rectangle =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRoundedRectangleProfileDef>(rectangle_profile);
+							oip::entityCast<typename IfcEntityTypesT::IfcRoundedRectangleProfileDef>(rectangle_profile);
 						if(rounded_rectangle) {
 							if(rounded_rectangle->RoundingRadius) {
 								double rr = rounded_rectangle->RoundingRadius * length_factor;
@@ -602,7 +603,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (2/10) IfcTrapeziumProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcTrapeziumProfileDef> trapezium = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTrapeziumProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcTrapeziumProfileDef> trapezium = oip::entityCast<typename IfcEntityTypesT::IfcTrapeziumProfileDef>(profileDef);
 				if(trapezium) {
 					if(trapezium->BottomXDim && trapezium->TopXDim && trapezium->TopXOffset && trapezium->YDim) {
 						double xBottom = trapezium->BottomXDim * length_factor;
@@ -619,7 +620,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (3/10) IfcCircleProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcCircleProfileDef> circle_profile_def = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCircleProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcCircleProfileDef> circle_profile_def = oip::entityCast<typename IfcEntityTypesT::IfcCircleProfileDef>(profileDef);
 				if(circle_profile_def) {
 					double radius = circle_profile_def->Radius * length_factor;
 					if(radius < 0.000001) {
@@ -636,7 +637,7 @@ namespace OpenInfraPlatform {
 
 					// IfcCircleHollowProfileDef SUBTYPE OF IfcCircleProfileDef
 					std::vector<carve::geom::vector<2>> inner_loop;
-					std::shared_ptr<typename IfcEntityTypesT::IfcCircleHollowProfileDef> hollow = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCircleHollowProfileDef>(profileDef);
+					std::shared_ptr<typename IfcEntityTypesT::IfcCircleHollowProfileDef> hollow = oip::entityCast<typename IfcEntityTypesT::IfcCircleHollowProfileDef>(profileDef);
 					if(hollow) {
 						angle = 0;
 						double radius2 = radius - hollow->WallThickness * length_factor;
@@ -653,7 +654,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (4/10) IfcEllipseProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcEllipseProfileDef> ellipse_profile_def = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcEllipseProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcEllipseProfileDef> ellipse_profile_def = oip::entityCast<typename IfcEntityTypesT::IfcEllipseProfileDef>(profileDef);
 				if(ellipse_profile_def) {
 					if(ellipse_profile_def->SemiAxis1) {
 						if(ellipse_profile_def->SemiAxis2) {
@@ -674,7 +675,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (5/10) IfcIShapeProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcIShapeProfileDef> i_shape = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcIShapeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcIShapeProfileDef> i_shape = oip::entityCast<typename IfcEntityTypesT::IfcIShapeProfileDef>(profileDef);
 				if(i_shape) {
 					if(i_shape->OverallDepth && i_shape->OverallWidth && i_shape->WebThickness && i_shape->FlangeThickness) {
 						double h = i_shape->OverallDepth * length_factor;
@@ -698,7 +699,7 @@ namespace OpenInfraPlatform {
 
 						// IfcAsymmetricIShapeProfileDef SUBTYPE OF IfcIShapeProfileDef
 						std::shared_ptr<typename IfcEntityTypesT::IfcAsymmetricIShapeProfileDef> asym_I_profile =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAsymmetricIShapeProfileDef>(i_shape);
+							oip::entityCast<typename IfcEntityTypesT::IfcAsymmetricIShapeProfileDef>(i_shape);
 						if(asym_I_profile) {
 							if(asym_I_profile->TopFlangeWidth) {
 								double bTop = asym_I_profile->TopFlangeWidth * length_factor;
@@ -735,7 +736,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (6/10) IfcLShapeProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcLShapeProfileDef> l_shape = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcLShapeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcLShapeProfileDef> l_shape = oip::entityCast<typename IfcEntityTypesT::IfcLShapeProfileDef>(profileDef);
 				if(l_shape) {
 					if(l_shape->Depth && l_shape->Thickness) {
 						double h = l_shape->Depth * length_factor;
@@ -797,7 +798,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (7/10) IfcUShapeProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcUShapeProfileDef> u_shape = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcUShapeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcUShapeProfileDef> u_shape = oip::entityCast<typename IfcEntityTypesT::IfcUShapeProfileDef>(profileDef);
 				if(u_shape) {
 					if(u_shape->Depth && u_shape->FlangeWidth && u_shape->WebThickness && u_shape->FlangeThickness) {
 						double h = u_shape->Depth * length_factor;
@@ -844,7 +845,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (8/10) IfcCShapeProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcCShapeProfileDef> c_shape = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCShapeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcCShapeProfileDef> c_shape = oip::entityCast<typename IfcEntityTypesT::IfcCShapeProfileDef>(profileDef);
 				if(c_shape) {
 					if(c_shape->Depth && c_shape->Width && c_shape->Girth && c_shape->WallThickness) {
 						double h = c_shape->Depth * length_factor;
@@ -894,7 +895,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (9/10) IfcZShapeProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcZShapeProfileDef> z_shape = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcZShapeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcZShapeProfileDef> z_shape = oip::entityCast<typename IfcEntityTypesT::IfcZShapeProfileDef>(profileDef);
 				if(z_shape) {
 					if(z_shape->Depth && z_shape->FlangeWidth && z_shape->WebThickness && z_shape->FlangeThickness) {
 						double h = z_shape->Depth * length_factor;
@@ -936,7 +937,7 @@ namespace OpenInfraPlatform {
 				}
 
 				// (10/10) IfcTShapeProfileDef SUBTYPE OF IfcParametrizedProfileDef
-				std::shared_ptr<typename IfcEntityTypesT::IfcTShapeProfileDef> t_shape = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTShapeProfileDef>(profileDef);
+				std::shared_ptr<typename IfcEntityTypesT::IfcTShapeProfileDef> t_shape = oip::entityCast<typename IfcEntityTypesT::IfcTShapeProfileDef>(profileDef);
 				if(t_shape) {
 					const double h = t_shape->Depth * length_factor;
 					const double b = t_shape->FlangeWidth * length_factor;
@@ -1105,11 +1106,11 @@ namespace OpenInfraPlatform {
 				const double lengthFactor = UnitConvert()->getLengthInMeterFactor();
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef> outer_curve =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(profile_with_voids);
+					oip::entityCast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(profile_with_voids);
 				std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcCurve>> inner_curves = profile_with_voids->InnerCurves;
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef> next_outer_curve =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(next_profile_with_voids);
+					oip::entityCast<typename IfcEntityTypesT::IfcArbitraryClosedProfileDef>(next_profile_with_voids);
 				std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcCurve>> next_inner_curves = next_profile_with_voids->InnerCurves;
 
 				// if there is any outer curve (as closed profile) convert it to geometry first
@@ -1121,17 +1122,17 @@ namespace OpenInfraPlatform {
 				for(int i = 0; i < inner_curves.size(); ++i) {
 					// this inner curve
 					std::shared_ptr<typename IfcEntityTypesT::IfcCurve> inner_curve = inner_curves[i];
-					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> polyline = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyline>(inner_curve);
+					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> polyline = oip::entityCast<typename IfcEntityTypesT::IfcPolyline>(inner_curve);
 
 					// next inner curve
 					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> next_polyline;
 					if(next_inner_curves.size() == inner_curves.size()) {
 						std::shared_ptr<typename IfcEntityTypesT::IfcCurve> next_inner_curve = next_inner_curves[i];
-						next_polyline = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyline>(next_inner_curve);
+						next_polyline = oip::entityCast<typename IfcEntityTypesT::IfcPolyline>(next_inner_curve);
 					}
 
 					if(polyline) {
-						std::shared_ptr<typename IfcEntityTypesT::IfcBoundedCurve> bounded_curve = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBoundedCurve>(polyline);
+						std::shared_ptr<typename IfcEntityTypesT::IfcBoundedCurve> bounded_curve = oip::entityCast<typename IfcEntityTypesT::IfcBoundedCurve>(polyline);
 
 						// describe 2D-polyline geometry
 						std::shared_ptr<carve::input::PolylineSetData> polylineData(new carve::input::PolylineSetData());
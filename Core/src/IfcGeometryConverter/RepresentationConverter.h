@@ -39,8 +39,12 @@
 #include "PlacementConverter.h"
 #include "ProfileCache.h"
 #include "ProfileConverter.h"
+#include "RepresentationMapCache.h"
 #include "SolidModelConverter.h"
 
+#include "EXPRESS/EXPRESSEntityCast.h"
+#include "EXPRESS/EXPRESSModel.h"
+
 #include "BlueFramework/Core/Diagnostics/log.h"
 
 
@@ -74,6 +78,7 @@ namespace OpenInfraPlatform {
 					faceConverter = std::make_shared<FaceConverterT<IfcEntityTypesT>>(geomSettings, unitConverter, placementConverter, curveConverter);
 
 					profileCache = std::make_shared<ProfileCacheT<IfcEntityTypesT>>(geomSettings, unitConverter, placementConverter);
+					representationMapCache = std::make_shared<RepresentationMapCache>();
 					solidConverter =
 						std::make_shared<SolidModelConverterT<IfcEntityTypesT>>(geomSettings, unitConverter, placementConverter, curveConverter, faceConverter, profileCache);
 				}
@@ -101,7 +106,7 @@ namespace OpenInfraPlatform {
 
 						// (1/4) IfcGeometricRepresenationItem SUBTYPE OF IfcRepresentationItem
 						std::shared_ptr<typename IfcEntityTypesT::IfcGeometricRepresentationItem> geom_item =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGeometricRepresentationItem>(representation_item);
+							oip::entityCast<typename IfcEntityTypesT::IfcGeometricRepresentationItem>(representation_item);
 						if(geom_item) {
 #ifdef _DEBUG
 							BLUE_LOG(trace) << "Processing IfcGeometricRepresentationItem #" << geom_item->getId();
@@ -114,7 +119,7 @@ namespace OpenInfraPlatform {
 						}
 
 						// (2/4) IfcMappedItem SUBTYPE OF IfcRepresentationItem
-						std::shared_ptr<typename IfcEntityTypesT::IfcMappedItem> mapped_item = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcMappedItem>(representation_item);
+						std::shared_ptr<typename IfcEntityTypesT::IfcMappedItem> mapped_item = oip::entityCast<typename IfcEntityTypesT::IfcMappedItem>(representation_item);
 						if(mapped_item) {
 							// decltype(mapped_item->MappingSource)::type &map_source = mapped_item->MappingSource;
 							auto& map_source = mapped_item->MappingSource;
@@ -144,8 +149,8 @@ namespace OpenInfraPlatform {
 							std::shared_ptr<typename IfcEntityTypesT::IfcPlacement> mapping_origin_placement = nullptr;
 
 							switch(mapping_origin_select.which()) {
-							case 0: mapping_origin_placement = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPlacement>(mapping_origin_select.get<0>().lock()); break;
-							case 1: mapping_origin_placement = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPlacement>(mapping_origin_select.get<1>().lock()); break;
+							case 0: mapping_origin_placement = oip::entityCast<typename IfcEntityTypesT::IfcPlacement>(mapping_origin_select.get<0>().lock()); break;
+							case 1: mapping_origin_placement = oip::entityCast<typename IfcEntityTypesT::IfcPlacement>(mapping_origin_select.get<1>().lock()); break;
 							default: break;
 							}
 
@@ -160,7 +165,52 @@ namespace OpenInfraPlatform {
 
 							carve::math::Matrix mapped_pos((map_matrix_origin * objectPlacement) * map_matrix_target);
 
-							convertIfcRepresentation(mapped_representation.lock(), mapped_pos, inputData, err);
+							if(RepresentationMapCache::isInstantiable(mapped_pos)) {
+								// the mapped representation is converted once in its own coordinate system, the mapped items only refer to it
+								const int map_id = map_source->getId();
+								std::shared_ptr<const RepresentationMapGeometry> map_geometry = representationMapCache->getRepresentationMap(map_id);
+								if(!map_geometry) {
+									std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>> mapData = std::make_shared<ShapeInputDataT<IfcEntityTypesT>>();
+									convertIfcRepresentation(mapped_representation.lock(), carve::math::Matrix::IDENT(), mapData, err);
+
+									// the polyhedrons become simplified meshsets once for the map, see IfcImporterUtil::computeMeshsetsFromPolyhedrons
+									std::shared_ptr<RepresentationMapGeometry> converted_geometry = std::make_shared<RepresentationMapGeometry>();
+									for(auto& mapItemData : mapData->vec_item_data) {
+										mapItemData->createMeshSetsFromClosedPolyhedrons();
+										for(const auto& polyhedrons : { &mapItemData->open_polyhedrons, &mapItemData->open_or_closed_polyhedrons }) {
+											for(const auto& polyData : *polyhedrons) {
+												if(polyData->getVertexCount() < 3) { continue; }
+
+												mapItemData->meshsets.push_back(std::shared_ptr<carve::mesh::MeshSet<3>>(polyData->createMesh(carve::input::opts())));
+											}
+											polyhedrons->clear();
+										}
+										for(auto& meshset : mapItemData->meshsets) {
+											solidConverter->simplifyMesh(meshset);
+										}
+										converted_geometry->vec_item_data.push_back(mapItemData);
+									}
+									map_geometry = representationMapCache->addRepresentationMap(map_id, converted_geometry);
+								}
+
+								for(const auto& mapItemData : map_geometry->vec_item_data) {
+									// the geometry is only copied if openings are subtracted, see subtractOpenings
+									std::shared_ptr<ItemData> instanceData = std::make_shared<ItemData>();
+									// items of nested maps refer to the prototype of the innermost map
+									if(mapItemData->prototype) {
+										instanceData->prototype = mapItemData->prototype;
+										instanceData->prototype_transform = mapped_pos * mapItemData->prototype_transform;
+									}
+									else {
+										instanceData->prototype = mapItemData;
+										instanceData->prototype_transform = mapped_pos;
+									}
+									inputData->vec_item_data.push_back(instanceData);
+								}
+							}
+							else {
+								convertIfcRepresentation(mapped_representation.lock(), mapped_pos, inputData, err);
+							}
 #ifdef _DEBUG
 							BLUE_LOG(trace) << "Processed IfcMappedItem #" << mapped_representation.lock()->getId();
 #endif
@@ -168,7 +218,7 @@ namespace OpenInfraPlatform {
 						}
 
 						// (3/4) IfcStyledItem SUBTYPE OF IfcRepresentationItem
-						std::shared_ptr<typename IfcEntityTypesT::IfcStyledItem> styled_item = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcStyledItem>(representation_item);
+						std::shared_ptr<typename IfcEntityTypesT::IfcStyledItem> styled_item = oip::entityCast<typename IfcEntityTypesT::IfcStyledItem>(representation_item);
 						if(styled_item) {
 							BLUE_LOG(warning) << "#" << styled_item->getId() << " = IfcStyledItem: Not implemented yet!";
 							continue;
@@ -176,20 +226,20 @@ namespace OpenInfraPlatform {
 
 						// (4/4) IfcTopologicalRepresentationItem SUBTYPE OF IfcRepresentationItem
 						std::shared_ptr<typename IfcEntityTypesT::IfcTopologicalRepresentationItem> topo_item =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTopologicalRepresentationItem>(representation_item);
+							oip::entityCast<typename IfcEntityTypesT::IfcTopologicalRepresentationItem>(representation_item);
 						if(topo_item) {
 							// IfcTopologicalRepresentationItem ABSTRACT SUPERTYPE OF IfcConnectedFaceSet, IfcEdge, IfcFace*, IfcFaceBound*, IfcLoop*, IfcPath*, IfcVertex*.
 
 							// IfcConnectedFaceSet SUBTYPE OF IfcTopologicalRepresentationItem
 							std::shared_ptr<typename IfcEntityTypesT::IfcConnectedFaceSet> topo_connected_face_set =
-								std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcConnectedFaceSet>(topo_item);
+								oip::entityCast<typename IfcEntityTypesT::IfcConnectedFaceSet>(topo_item);
 							if(topo_connected_face_set) {
 								BLUE_LOG(warning) << "#" << topo_item->getId() << " = IfcTopologicalRepresentationItem: #" << topo_connected_face_set ->getId() << " = IfcConnectedFaceSet not implemented yet";
 								continue;
 							}
 
 							// IfcEdge SUBTYPE OF IfcTopologicalRepresentationItem
-							std::shared_ptr<typename IfcEntityTypesT::IfcEdge> topo_edge = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcEdge>(topo_item);
+							std::shared_ptr<typename IfcEntityTypesT::IfcEdge> topo_edge = oip::entityCast<typename IfcEntityTypesT::IfcEdge>(topo_item);
 							if(topo_edge) {
 								std::shared_ptr<carve::input::PolylineSetData> polyline_data(new carve::input::PolylineSetData());
 								polyline_data->beginPolyline();
@@ -198,14 +248,14 @@ namespace OpenInfraPlatform {
 								auto& vertex_start = topo_edge->EdgeStart;
 
 								std::shared_ptr<typename IfcEntityTypesT::IfcVertexPoint> vertex_start_point =
-									std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcVertexPoint>(vertex_start.lock());
+									oip::entityCast<typename IfcEntityTypesT::IfcVertexPoint>(vertex_start.lock());
 
 								if(vertex_start_point) {
 									if(vertex_start_point->VertexGeometry) {
 										auto& edge_start_point_geometry = vertex_start_point->VertexGeometry;
 
 										std::shared_ptr<typename IfcEntityTypesT::IfcCartesianPoint> ifc_point =
-											std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianPoint>(edge_start_point_geometry.lock());
+											oip::entityCast<typename IfcEntityTypesT::IfcCartesianPoint>(edge_start_point_geometry.lock());
 										if(ifc_point) {
 											if(ifc_point->Coordinates.size() > 2) {
 												carve::geom::vector<3> point = carve::geom::VECTOR(ifc_point->Coordinates[0] * length_factor, ifc_point->Coordinates[1] * length_factor,
@@ -221,13 +271,13 @@ namespace OpenInfraPlatform {
 								// decltype(topo_edge->EdgeEnd)::type& vertex_end = topo_edge->EdgeEnd;
 								auto& vertex_end = topo_edge->EdgeEnd;
 								std::shared_ptr<typename IfcEntityTypesT::IfcVertexPoint> vertex_end_point =
-									std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcVertexPoint>(vertex_end.lock());
+									oip::entityCast<typename IfcEntityTypesT::IfcVertexPoint>(vertex_end.lock());
 								if(vertex_end_point) {
 									if(vertex_end_point->VertexGeometry) {
 										auto& edge_point_geometry = vertex_end_point->VertexGeometry;
 
 										std::shared_ptr<typename IfcEntityTypesT::IfcCartesianPoint> ifc_point =
-											std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCartesianPoint>(edge_point_geometry.lock());
+											oip::entityCast<typename IfcEntityTypesT::IfcCartesianPoint>(edge_point_geometry.lock());
 										if(ifc_point) {
 											if(ifc_point->Coordinates.size() > 2) {
 												carve::geom::vector<3> point = carve::geom::VECTOR(ifc_point->Coordinates[0] * length_factor, ifc_point->Coordinates[1] * length_factor,
@@ -287,7 +337,7 @@ namespace OpenInfraPlatform {
 				{
 					// (1/9) IfcFaceBasedSurfaceModel SUBTYPE OF IfcGeometricRepresentationItem
 					std::shared_ptr<typename IfcEntityTypesT::IfcFaceBasedSurfaceModel> surface_model =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcFaceBasedSurfaceModel>(geomItem);
+						oip::entityCast<typename IfcEntityTypesT::IfcFaceBasedSurfaceModel>(geomItem);
 					if(surface_model) {
 #ifdef _DEBUG
 						BLUE_LOG(trace) << "Processing IfcFaceBasedSurfaceModel #" << surface_model->getId();
@@ -318,7 +368,7 @@ namespace OpenInfraPlatform {
 					}
 
 					// (2/9) IfcBooleanResult SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcBooleanResult> boolean_result = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBooleanResult>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcBooleanResult> boolean_result = oip::entityCast<typename IfcEntityTypesT::IfcBooleanResult>(geomItem);
 					if(boolean_result) {
 						try {
 #ifdef _DEBUG
@@ -336,14 +386,14 @@ namespace OpenInfraPlatform {
 					}
 
 					// (3/9) IfcSolidModel SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcSolidModel> solid_model = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSolidModel>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcSolidModel> solid_model = oip::entityCast<typename IfcEntityTypesT::IfcSolidModel>(geomItem);
 					if(solid_model) {
 						solidConverter->convertIfcSolidModel(solid_model, pos, itemData, err);
 						return;
 					}
 
 					// (4/9) IfcCurve SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcCurve> curve = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCurve>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcCurve> curve = oip::entityCast<typename IfcEntityTypesT::IfcCurve>(geomItem);
 					if(curve) {
 						std::vector<carve::geom::vector<3>> loops;
 						std::vector<carve::geom::vector<3>> segment_start_points;
@@ -363,7 +413,7 @@ namespace OpenInfraPlatform {
 
 					// (5/9) IfcShellBasedSurfaceModel SUBTYPE OF IfcGeometricRepresentationItem
 					std::shared_ptr<typename IfcEntityTypesT::IfcShellBasedSurfaceModel> shell_based_surface_model =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcShellBasedSurfaceModel>(geomItem);
+						oip::entityCast<typename IfcEntityTypesT::IfcShellBasedSurfaceModel>(geomItem);
 					if(shell_based_surface_model) {
 #ifdef _DEBUG
 						BLUE_LOG(trace) << "Processing IfcShellBasedSurfaceModel #" << shell_based_surface_model->getId();
@@ -402,7 +452,7 @@ namespace OpenInfraPlatform {
 					}
 
 					// (6/9) IfcSurface SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcSurface> surface = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSurface>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcSurface> surface = oip::entityCast<typename IfcEntityTypesT::IfcSurface>(geomItem);
 					if(surface) {
 						std::shared_ptr<carve::input::PolylineSetData> polyline(new carve::input::PolylineSetData());
 						faceConverter->convertIfcSurface(surface, pos, polyline);
@@ -413,7 +463,7 @@ namespace OpenInfraPlatform {
 					}
 
 					// (7/9) IfcPolyline SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> poly_line = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolyline>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcPolyline> poly_line = oip::entityCast<typename IfcEntityTypesT::IfcPolyline>(geomItem);
 					if(poly_line) {
 						std::vector<carve::geom::vector<3>> poly_vertices;
 						curveConverter->convertIfcPolyline(poly_line, poly_vertices);
@@ -437,7 +487,7 @@ namespace OpenInfraPlatform {
 					}
 
 					// (8/9) IfcGeometricSet SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcGeometricSet> geometric_set = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGeometricSet>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcGeometricSet> geometric_set = oip::entityCast<typename IfcEntityTypesT::IfcGeometricSet>(geomItem);
 					if(geometric_set) {
 						// ENTITY IfcGeometricSet SUPERTYPE OF(IfcGeometricCurveSet)
 
@@ -459,7 +509,7 @@ namespace OpenInfraPlatform {
 						}
 
 						std::shared_ptr<typename IfcEntityTypesT::IfcGeometricCurveSet> geometric_curve_set =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcGeometricCurveSet>(geometric_set);
+							oip::entityCast<typename IfcEntityTypesT::IfcGeometricCurveSet>(geometric_set);
 						if(geometric_curve_set) {
 #ifdef _DEBUG
 							std::cout << "Warning\t| IfcGeometricCurveSet not implemented" << std::endl;
@@ -470,13 +520,13 @@ namespace OpenInfraPlatform {
 					}
 
 					// (9/9) IfcSectionedSpine SUBTYPE OF IfcGeometricRepresentationItem
-					std::shared_ptr<typename IfcEntityTypesT::IfcSectionedSpine> sectioned_spine = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSectionedSpine>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcSectionedSpine> sectioned_spine = oip::entityCast<typename IfcEntityTypesT::IfcSectionedSpine>(geomItem);
 					if(sectioned_spine) {
 						convertIfcSectionedSpine(sectioned_spine, pos, itemData, err);
 						return;
 					}
 
-					std::shared_ptr<typename IfcEntityTypesT::IfcTriangulatedFaceSet> faceSet = std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcTriangulatedFaceSet>(geomItem);
+					std::shared_ptr<typename IfcEntityTypesT::IfcTriangulatedFaceSet> faceSet = oip::entityCast<typename IfcEntityTypesT::IfcTriangulatedFaceSet>(geomItem);
 					if (faceSet) {
 						std::shared_ptr<carve::input::PolyhedronData> polygon(new carve::input::PolyhedronData());
 												
@@ -603,66 +653,33 @@ namespace OpenInfraPlatform {
 					std::vector<std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>>>& vecOpeningData,
 					std::stringstream& err)
 				{
-					//	std::vector<std::weak_ptr<typename IfcEntityTypesT::IfcRelVoidsElement>> vec_rel_voids(
-					//		ifcElement->HasOpenings_inverse);
-					//	if (vec_rel_voids.size() == 0)
-					//	{
-					//		return;
-					//	}
-					//	const int product_id = ifcElement->getId();
-					//	const double length_factor = UnitConvert()->getLengthInMeterFactor();
-					//
-					//	// convert opening representation
-					//	for (int i_void = 0; i_void<vec_rel_voids.size(); ++i_void)
-					//	{
-					//		std::weak_ptr<typename IfcEntityTypesT::IfcRelVoidsElement>& rel_voids_weak = vec_rel_voids[i_void];
-					//		if (rel_voids_weak.expired())
-					//		{
-					//			continue;
-					//		}
-					//		std::shared_ptr<typename IfcEntityTypesT::IfcRelVoidsElement> rel_voids(rel_voids_weak);
-					//		std::shared_ptr<typename IfcEntityTypesT::IfcFeatureElementSubtraction> opening = rel_voids->RelatedOpeningElement;
-					//		if (!opening)
-					//		{
-					//			continue;
-					//		}
-					//		if (!opening->Representation)
-					//		{
-					//			continue;
-					//		}
-					//
-					//		const int opening_id = opening->getId();
-					//
-					//		// opening can have its own relative placement
-					//		std::shared_ptr<typename IfcEntityTypesT::IfcObjectPlacement> opening_placement = opening->ObjectPlacement;			//optional
-					//		carve::math::Matrix opening_placement_matrix(carve::math::Matrix::IDENT());
-					//		if (opening_placement)
-					//		{
-					//			std::set<int> opening_placements_applied;
-					//			PlacementConverterT<IfcEntityTypesT>::convertIfcObjectPlacement(opening_placement,
-					//				opening_placement_matrix, length_factor, opening_placements_applied);
-					//		}
-					//
-					//		std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcRepresentation>>& vec_opening_representations =
-					//			opening->Representation->Representations;
-					//
-					//		for (typename std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcRepresentation>>::iterator
-					//			it_representations = vec_opening_representations.begin();
-					//			it_representations != vec_opening_representations.end(); ++it_representations)
-					//		{
-					//			std::shared_ptr<typename IfcEntityTypesT::IfcRepresentation> ifc_opening_representation = (*it_representations);
-					//			std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>> opening_representation_data(new ShapeInputDataT<IfcEntityTypesT>());
-					//
-					//			opening_representation_data->representation = ifc_opening_representation;
-					//
-					//			// TODO: Representation caching, one element could be used for several openings
-					//			convertIfcRepresentation(ifc_opening_representation, opening_placement_matrix,
-					//				opening_representation_data, err);
-					//
-					//
-					//			vecOpeningData.push_back(opening_representation_data);
-					//		}
-					//	}
+					if(!model) {
+						return;
+					}
+
+					// the openings voiding the element are found through the inverse attribute HasOpenings
+					for(auto& relVoids : ifcElement->HasOpenings(*model)) {
+						EXPRESSReference<typename IfcEntityTypesT::IfcFeatureElementSubtraction>& opening = relVoids.RelatedOpeningElement;
+						if(!opening || !opening->Representation) {
+							continue;
+						}
+
+						// opening can have its own relative placement
+						carve::math::Matrix openingPlacement(carve::math::Matrix::IDENT());
+						if(opening->ObjectPlacement) {
+							EXPRESSReference<typename IfcEntityTypesT::IfcObjectPlacement>& objectPlacement = opening->ObjectPlacement;
+							std::vector<std::shared_ptr<typename IfcEntityTypesT::IfcObjectPlacement>> placementAlreadyApplied;
+							placementConverter->convertIfcObjectPlacement(objectPlacement.lock(), openingPlacement, placementAlreadyApplied);
+						}
+
+						EXPRESSReference<typename IfcEntityTypesT::IfcProductRepresentation>& representation = opening->Representation;
+						for(EXPRESSReference<typename IfcEntityTypesT::IfcRepresentation>& rep : representation->Representations) {
+							std::shared_ptr<ShapeInputDataT<IfcEntityTypesT>> openingData = std::make_shared<ShapeInputDataT<IfcEntityTypesT>>();
+							openingData->representation = rep.lock();
+							convertIfcRepresentation(rep.lock(), openingPlacement, openingData, err);
+							vecOpeningData.push_back(openingData);
+						}
+					}
 				}
 
 				// Function 5: Subtract openings.
@@ -673,6 +690,11 @@ namespace OpenInfraPlatform {
 				{
 					const int product_id = ifcElement->getId();
 
+					// the openings change the geometry, so the item needs its own copy of the geometry of its representation map
+					if(!vecOpeningData.empty()) {
+						itemData->copyPrototypeGeometry();
+					}
+
 					// now go through all meshsets of the item
 					for(int i_product_meshset = 0; i_product_meshset < itemData->meshsets.size(); ++i_product_meshset) {
 						std::shared_ptr<carve::mesh::MeshSet<3>>& product_meshset = itemData->meshsets[i_product_meshset];
@@ -694,6 +716,7 @@ namespace OpenInfraPlatform {
 
 							for(int i_item = 0; i_item < vec_opening_items.size(); ++i_item) {
 								std::shared_ptr<ItemData>& opening_item_data = vec_opening_items[i_item];
+								opening_item_data->copyPrototypeGeometry();
 								opening_item_data->createMeshSetsFromClosedPolyhedrons();
 
 								std::vector<std::shared_ptr<carve::mesh::MeshSet<3>>>::iterator it_opening_meshsets = opening_item_data->meshsets.begin();
@@ -767,10 +790,20 @@ namespace OpenInfraPlatform {
 				{
 					return solidConverter;
 				}
+				void setModel(const std::shared_ptr<oip::EXPRESSModel>& model)
+				{
+					this->model = model;
+					// the cache is keyed by the ids of the previous model
+					representationMapCache->clearRepresentationMapCache();
+				}
 				std::shared_ptr<ProfileCacheT<IfcEntityTypesT>>& getProfileCache()
 				{
 					return profileCache;
 				}
+				std::shared_ptr<RepresentationMapCache>& getRepresentationMapCache()
+				{
+					return representationMapCache;
+				}
 				bool handleLayerAssignments()
 				{
 					return handle_layer_assignments;
@@ -796,6 +829,10 @@ namespace OpenInfraPlatform {
 				std::shared_ptr<SolidModelConverterT<IfcEntityTypesT>> solidConverter;
 				std::shared_ptr<FaceConverterT<IfcEntityTypesT>> faceConverter;
 				std::shared_ptr<ProfileCacheT<IfcEntityTypesT>> profileCache;
+				std::shared_ptr<RepresentationMapCache> representationMapCache;
+
+				// model of the converted entities, answers inverse attributes
+				std::shared_ptr<oip::EXPRESSModel> model;
 
 				bool handle_styled_items;
 				bool handle_layer_assignments;
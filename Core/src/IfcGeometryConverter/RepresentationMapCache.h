@@ -0,0 +1,86 @@
+/*
+    Copyright (c) 2018 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// visual studio
+#pragma once
+// unix
+#ifndef REPRESENTATIONMAPCACHE_H
+#define REPRESENTATIONMAPCACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CarveHeaders.h"
+#include "GeometryInputData.h"
+
+namespace OpenInfraPlatform {
+	namespace Core {
+		namespace IfcGeometryConverter {
+			// Geometry of an IfcRepresentationMap, converted once in the coordinate system of the map.
+			// The items are shared by all mapped items referring to the map and must not be modified.
+			class RepresentationMapGeometry
+			{
+			public:
+				std::vector<std::shared_ptr<ItemData>> vec_item_data;
+			};
+
+			// Converted IfcRepresentationMaps by id, shared by the products converted in parallel.
+			class RepresentationMapCache
+			{
+			public:
+				std::shared_ptr<const RepresentationMapGeometry> getRepresentationMap(const int map_id)
+				{
+					std::lock_guard<std::mutex> lock(representationMapCacheMutex);
+					auto it_map_cache = representationMapCache.find(map_id);
+					return it_map_cache != representationMapCache.end() ? it_map_cache->second : nullptr;
+				}
+
+				// if another thread added the same map in the meantime, the geometry added first is returned
+				std::shared_ptr<const RepresentationMapGeometry> addRepresentationMap(const int map_id,
+					const std::shared_ptr<const RepresentationMapGeometry>& geometry)
+				{
+					std::lock_guard<std::mutex> lock(representationMapCacheMutex);
+					return representationMapCache.insert(std::make_pair(map_id, geometry)).first->second;
+				}
+
+				void clearRepresentationMapCache()
+				{
+					std::lock_guard<std::mutex> lock(representationMapCacheMutex);
+					representationMapCache.clear();
+				}
+
+				// a mirroring transformation turns the faces inside out, such instances are converted without the cache
+				static bool isInstantiable(const carve::math::Matrix& matrix)
+				{
+					const double determinant =
+						matrix.m[0][0] * (matrix.m[1][1] * matrix.m[2][2] - matrix.m[2][1] * matrix.m[1][2])
+						- matrix.m[1][0] * (matrix.m[0][1] * matrix.m[2][2] - matrix.m[2][1] * matrix.m[0][2])
+						+ matrix.m[2][0] * (matrix.m[0][1] * matrix.m[1][2] - matrix.m[1][1] * matrix.m[0][2]);
+					return determinant > 0.0;
+				}
+
+			protected:
+				std::map<int, std::shared_ptr<const RepresentationMapGeometry>> representationMapCache;
+				std::mutex representationMapCacheMutex;
+			};
+		}
+	}
+}
+
+#endif
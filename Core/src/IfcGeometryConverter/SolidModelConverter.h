@@ -32,6 +32,7 @@
 #include "CurveConverter.h"
 
 #include "EXPRESS/EXPRESSEntity.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 namespace OpenInfraPlatform
 {
@@ -104,7 +105,7 @@ namespace OpenInfraPlatform
 				BLUE_LOG(trace) << "Processing IfcSolidModel #" << solidModel->getId();
 #endif
 				std::shared_ptr<typename IfcEntityTypesT::IfcCsgSolid> csg_solid =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcCsgSolid>(solidModel);
+					oip::entityCast<typename IfcEntityTypesT::IfcCsgSolid>(solidModel);
 				if (csg_solid)
 				{
 #ifdef _DEBUG
@@ -150,7 +151,7 @@ namespace OpenInfraPlatform
 				// *****************************************************************************************************************************************//
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcManifoldSolidBrep> manifoldSolidBrep =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcManifoldSolidBrep>(solidModel);
+					oip::entityCast<typename IfcEntityTypesT::IfcManifoldSolidBrep>(solidModel);
 
 				if (manifoldSolidBrep) {
 #ifdef _DEBUG
@@ -193,7 +194,7 @@ namespace OpenInfraPlatform
 
 					  // (1/2) IfcAdvancedBrep SUBTYPE of IfcManifoldSolidBrep
 					std::shared_ptr<typename IfcEntityTypesT::IfcAdvancedBrep> advanced_brep =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAdvancedBrep>(manifoldSolidBrep);
+						oip::entityCast<typename IfcEntityTypesT::IfcAdvancedBrep>(manifoldSolidBrep);
 					if (advanced_brep)
 					{
 						// TO DO: formal proposition: every face shall be of the type IfcAdvancedFace.
@@ -201,7 +202,7 @@ namespace OpenInfraPlatform
 
 						// IfcAdvancedBrepWithVoids SUBTYPE of IfcAdvancedBrep
 						std::shared_ptr<typename IfcEntityTypesT::IfcAdvancedBrepWithVoids> advanced_brep_with_voids =
-							std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcAdvancedBrepWithVoids>(advanced_brep);
+							oip::entityCast<typename IfcEntityTypesT::IfcAdvancedBrepWithVoids>(advanced_brep);
 						if (advanced_brep_with_voids)
 						{
 							// Get voids (attribute 2). 
@@ -212,7 +213,7 @@ namespace OpenInfraPlatform
 
 					// (2/2) IfcFacetedBrep SUBTYPE of IfcManifoldSolidBrep
 					std::shared_ptr<typename IfcEntityTypesT::IfcFacetedBrep> faceted_brep =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcFacetedBrep>(manifoldSolidBrep);
+						oip::entityCast<typename IfcEntityTypesT::IfcFacetedBrep>(manifoldSolidBrep);
 					if (faceted_brep) {
 						// No additional attributes
 						// TO DO: informal propositions: all bounding loops are IfcPolyLoop, all vertices shall be referenced by all polyloops, i.e. each cartesian point referenced by at least three polyloops. 
@@ -229,7 +230,7 @@ namespace OpenInfraPlatform
 				// *****************************************************************************************************************************************//
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcSectionedSolid> sectioned_solid =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSectionedSolid>(solidModel);
+					oip::entityCast<typename IfcEntityTypesT::IfcSectionedSolid>(solidModel);
 
 				if (sectioned_solid)
 				{
@@ -245,7 +246,7 @@ namespace OpenInfraPlatform
 #endif
 					// (1/1) IfcSectionedSolidHorizontal SUBTYPE of IfcSectionedSolid
 					std::shared_ptr<typename IfcEntityTypesT::IfcSectionedSolidHorizontal> sectioned_solid_horizontal =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSectionedSolidHorizontal>(sectioned_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcSectionedSolidHorizontal>(sectioned_solid);
 
 					if (sectioned_solid_horizontal)
 					{
@@ -269,7 +270,7 @@ namespace OpenInfraPlatform
 				// *****************************************************************************************************************************************//
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcSweptAreaSolid> swept_area_solid =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSweptAreaSolid>(solidModel);
+					oip::entityCast<typename IfcEntityTypesT::IfcSweptAreaSolid>(solidModel);
 
 				if (swept_area_solid)
 				{
@@ -289,7 +290,7 @@ namespace OpenInfraPlatform
 
 					// (1/4) IfcExtrudedAreaSolid SUBTYPE of IfcSweptAreaSolid
 					std::shared_ptr<typename IfcEntityTypesT::IfcExtrudedAreaSolid> extruded_area =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcExtrudedAreaSolid>(swept_area_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcExtrudedAreaSolid>(swept_area_solid);
 					if (extruded_area)
 					{
 						// Get extruded direction and depth (attributes 3-4). 
@@ -306,7 +307,7 @@ namespace OpenInfraPlatform
 
 					// (2/4) IfcFixedReferenceSweptAreaSolid SUBTYPE of IfcSweptAreaSolid
 					std::shared_ptr<typename IfcEntityTypesT::IfcFixedReferenceSweptAreaSolid> fixed_ref_swept_area_solid =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcFixedReferenceSweptAreaSolid>(swept_area_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcFixedReferenceSweptAreaSolid>(swept_area_solid);
 					if (fixed_ref_swept_area_solid) {
 						// Get directrix, start parameter, end parameter and fixed reference (attributes 3-6).
 						//std::shared_ptr<typename IfcEntityTypesT::IfcCurve> directrix =
@@ -323,7 +324,7 @@ namespace OpenInfraPlatform
 
 					// (3/4) IfcRevolvedAreaSolid SUBTYPE of IfcSweptAreaSolid
 					std::shared_ptr<typename IfcEntityTypesT::IfcRevolvedAreaSolid> revolved_area_solid =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRevolvedAreaSolid>(swept_area_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcRevolvedAreaSolid>(swept_area_solid);
 					if (revolved_area_solid)
 					{
 						// Get axis and angle (attributes 3-4). 
@@ -339,7 +340,7 @@ namespace OpenInfraPlatform
 
 					// (4/4) IfcSurfaceCurveSweptAreaSolid SUBTYPE of IfcSweptAreaSolid
 					std::shared_ptr<typename IfcEntityTypesT::IfcSurfaceCurveSweptAreaSolid> surface_curve_swept_area_solid =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSurfaceCurveSweptAreaSolid>(swept_area_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcSurfaceCurveSweptAreaSolid>(swept_area_solid);
 					if (surface_curve_swept_area_solid)
 					{
 #ifdef _DEBUG
@@ -390,7 +391,7 @@ namespace OpenInfraPlatform
 				// *****************************************************************************************************************************************//
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcSweptDiskSolid> swept_disk_solid =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSweptDiskSolid>(solidModel);
+					oip::entityCast<typename IfcEntityTypesT::IfcSweptDiskSolid>(solidModel);
 				if (swept_disk_solid)
 				{
 					// Get directrix, radius, inner radius, start parameter and end parameter (attributes 1-5). 
@@ -416,7 +417,7 @@ namespace OpenInfraPlatform
 
 					// (1/1) IfcSweptDiskSolidPolygonal SUBTYPE of IfcSweptDiskSolid
 					std::shared_ptr<typename IfcEntityTypesT::IfcSweptDiskSolidPolygonal> swept_disk_solid_polygonal =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSweptDiskSolidPolygonal>(swept_disk_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcSweptDiskSolidPolygonal>(swept_disk_solid);
 					if (swept_disk_solid_polygonal)
 					{
 						// Get fillet radius (attribute 6). 
@@ -856,17 +857,17 @@ namespace OpenInfraPlatform
 				// direction and length of extrusion
 				const double depth = (typename IfcEntityTypesT::IfcLengthMeasure)(extrudedArea->Depth) * length_factor;
 				//const double depth = extrudedArea->Depth->length_factor;
-				carve::geom::vector<3>  extrusion_vector;
+				carve::geom::vector<3>  extrusion_direction = carve::geom::VECTOR(0, 0, 0);
 				auto& vec_direction = extrudedArea->ExtrudedDirection->DirectionRatios;
 				
 
 				if (vec_direction.size() > 2)
 				{
-					extrusion_vector = carve::geom::VECTOR(vec_direction[0] * depth, vec_direction[1] * depth, vec_direction[2] * depth);
+					extrusion_direction = carve::geom::VECTOR(vec_direction[0], vec_direction[1], vec_direction[2]);
 				}
 				else if (vec_direction.size() > 1)
 				{
-					extrusion_vector = carve::geom::VECTOR(vec_direction[0] * depth, vec_direction[1] * depth, 0);
+					extrusion_direction = carve::geom::VECTOR(vec_direction[0], vec_direction[1], 0);
 				}
 
 				// swept area
@@ -874,17 +875,15 @@ namespace OpenInfraPlatform
 #ifdef _DEBUG
 				BLUE_LOG(trace) << "Processing IfcExtrudedAreaSolid.SweptArea IfcProfileDef #" << swept_area->getId();
 #endif
-				std::shared_ptr<ProfileConverterT<IfcEntityTypesT>> profile_converter =
-					profileCache->getProfileConverter(swept_area);
-				profile_converter->simplifyPaths();
-				const std::vector<std::vector<carve::geom::vector<2>>>& paths = profile_converter->getCoordinates();
+				// the extrusion is tessellated once per profile, depth and direction and shared by all solids using it
+				std::shared_ptr<const carve::input::PolyhedronData> extrusion =
+					profileCache->getExtrusion(swept_area, depth, extrusion_direction, err);
 
-				if (paths.size() == 0)
+				if (!extrusion)
 				{
 					return;
 				}
-				std::shared_ptr<carve::input::PolyhedronData> poly_data(new carve::input::PolyhedronData);
-				GeomUtils::extrude(paths, extrusion_vector, poly_data, err);
+				std::shared_ptr<carve::input::PolyhedronData> poly_data(new carve::input::PolyhedronData(*extrusion));
 
 				// apply object coordinate system
 				std::transform(poly_data->points.begin(), poly_data->points.end(), poly_data->points.begin(), [pos](auto vertex) -> decltype(vertex) {return pos * vertex; });
@@ -1149,7 +1148,7 @@ namespace OpenInfraPlatform
 				BLUE_LOG(trace) << "Processing IfcBooleanResult #" << boolean_result_id;
 #endif
 				std::shared_ptr<typename IfcEntityTypesT::IfcBooleanClippingResult> boolean_clipping_result =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBooleanClippingResult>(boolResult);
+					oip::entityCast<typename IfcEntityTypesT::IfcBooleanClippingResult>(boolResult);
 				if (boolean_clipping_result)
 				{
 #ifdef _DEBUG
@@ -1280,7 +1279,7 @@ namespace OpenInfraPlatform
 				}
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcBlock> block =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBlock>(csgPrimitive);
+					oip::entityCast<typename IfcEntityTypesT::IfcBlock>(csgPrimitive);
 				if (block)
 				{
 					double x_length = length_factor;
@@ -1332,7 +1331,7 @@ namespace OpenInfraPlatform
 				}
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcRectangularPyramid> rectangular_pyramid =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRectangularPyramid>(csgPrimitive);
+					oip::entityCast<typename IfcEntityTypesT::IfcRectangularPyramid>(csgPrimitive);
 				if (rectangular_pyramid)
 				{
 					double x_length = length_factor;
@@ -1370,7 +1369,7 @@ namespace OpenInfraPlatform
 				}
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcRightCircularCone> right_circular_cone =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRightCircularCone>(csgPrimitive);
+					oip::entityCast<typename IfcEntityTypesT::IfcRightCircularCone>(csgPrimitive);
 				if (right_circular_cone)
 				{
 					if (!right_circular_cone->Height)
@@ -1416,7 +1415,7 @@ namespace OpenInfraPlatform
 				}
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcRightCircularCylinder> right_circular_cylinder =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcRightCircularCylinder>(csgPrimitive);
+					oip::entityCast<typename IfcEntityTypesT::IfcRightCircularCylinder>(csgPrimitive);
 				if (right_circular_cylinder)
 				{
 					if (!right_circular_cylinder->Height)
@@ -1458,7 +1457,7 @@ namespace OpenInfraPlatform
 				}
 
 				std::shared_ptr<typename IfcEntityTypesT::IfcSphere> sphere =
-					std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSphere>(csgPrimitive);
+					oip::entityCast<typename IfcEntityTypesT::IfcSphere>(csgPrimitive);
 				if (sphere)
 				{
 					if (!sphere->Radius)
@@ -1602,7 +1601,7 @@ namespace OpenInfraPlatform
 	
 					// base surface
 					std::shared_ptr<typename IfcEntityTypesT::IfcElementarySurface> elem_base_surface =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcElementarySurface>(base_surface);
+						oip::entityCast<typename IfcEntityTypesT::IfcElementarySurface>(base_surface);
 					if (!elem_base_surface)
 					{
 						BLUE_LOG(warning) << "The base surface shall be an unbounded surface (subtype of IfcElementarySurface)";
@@ -1626,7 +1625,7 @@ namespace OpenInfraPlatform
 					}
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcBoxedHalfSpace> boxed_half_space =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcBoxedHalfSpace>(half_space_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcBoxedHalfSpace>(half_space_solid);
 					if (boxed_half_space)
 					{
 #ifdef _DEBUG
@@ -1723,7 +1722,7 @@ namespace OpenInfraPlatform
 					}
 
 					std::shared_ptr<typename IfcEntityTypesT::IfcPolygonalBoundedHalfSpace> polygonal_half_space =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcPolygonalBoundedHalfSpace>(half_space_solid);
+						oip::entityCast<typename IfcEntityTypesT::IfcPolygonalBoundedHalfSpace>(half_space_solid);
 					if (polygonal_half_space)
 					{
 						// ENTITY IfcPolygonalBoundedHalfSpace 
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "BlueFramework/Core/Diagnostics/log.h"
+#include "EXPRESS/EXPRESSEntityCast.h"
 
 namespace OpenInfraPlatform 
 {
@@ -183,7 +184,7 @@ namespace OpenInfraPlatform
 
 					// (1/3) IfcContextDependentUnit
 					std::shared_ptr<typename IfcEntityTypesT::IfcContextDependentUnit> contextDependentUnit =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcContextDependentUnit>(unit);
+						oip::entityCast<typename IfcEntityTypesT::IfcContextDependentUnit>(unit);
 					if (contextDependentUnit)
 					{
 						//TODO
@@ -194,7 +195,7 @@ namespace OpenInfraPlatform
 
 					// (2/3) IfcConversionBasedUnit
 					std::shared_ptr<typename IfcEntityTypesT::IfcConversionBasedUnit> conversionBasedUnit =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcConversionBasedUnit>(unit);
+						oip::entityCast<typename IfcEntityTypesT::IfcConversionBasedUnit>(unit);
 					if (conversionBasedUnit)
 					{
 						// ENTITY IfcConversionBasedUnit
@@ -206,11 +207,11 @@ namespace OpenInfraPlatform
 						//	HasExternalReference : SET[0:? ] OF IfcExternalReferenceRelationship FOR RelatedResourceObjects;
 						// END_ENTITY;
 
-						if (std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcConversionBasedUnitWithOffset>(conversionBasedUnit))
+						if (oip::isOfType<typename IfcEntityTypesT::IfcConversionBasedUnitWithOffset>(conversionBasedUnit))
 						{
 							BLUE_LOG(warning) << conversionBasedUnit->getErrorLog() << ": .. with offset is not supported.";
 							BLUE_LOG(trace) << "Add "
-											<< std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcConversionBasedUnitWithOffset>(conversionBasedUnit)->ConversionOffset
+											<< oip::entityCast<typename IfcEntityTypesT::IfcConversionBasedUnitWithOffset>(conversionBasedUnit)->ConversionOffset
 											<< " to all values of with unit "
 											<< conversionBasedUnit->Name
 											<< " of type "
@@ -230,7 +231,7 @@ namespace OpenInfraPlatform
 
 					// (3/3) IfcSIUnit
 					std::shared_ptr<typename IfcEntityTypesT::IfcSIUnit> SIUnit =
-						std::dynamic_pointer_cast<typename IfcEntityTypesT::IfcSIUnit>(unit);
+						oip::entityCast<typename IfcEntityTypesT::IfcSIUnit>(unit);
 					if (SIUnit)
 					{
 						// ENTITY IfcSIUnit
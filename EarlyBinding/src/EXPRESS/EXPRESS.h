@@ -23,6 +23,7 @@
 
 #include "EXPRESSObject.h"
 #include "EXPRESSEntity.h"
+#include "EXPRESSReflection.h"
 #include "EXPRESSType.h"
 #include "EXPRESSModel.h"
 #include "EXPRESSContainer.h"
@@ -0,0 +1,86 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSArena_c81e5f3a_4d2b_4f96_8a7e_0b6d93c1e254_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSArena_c81e5f3a_4d2b_4f96_8a7e_0b6d93c1e254_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Model-owned storage for entities. Every entity type gets slabs of contiguous, default-constructed objects, so
+/// loading a model costs one allocation per type instead of one per entity. The shared pointers handed out by share()
+/// alias the arena and carry no control block of their own; the slabs are released together with the arena. Every
+/// entity knows its arena, so references can hand out such pointers as well.
+class EXPRESSArena : public std::enable_shared_from_this<EXPRESSArena> {
+public:
+	EXPRESSArena() = default;
+	EXPRESSArena(const EXPRESSArena&) = delete;
+	EXPRESSArena& operator=(const EXPRESSArena&) = delete;
+
+	/// Allocates a slab of count default-constructed entities. May be called from several threads.
+	template <typename T> T* allocate(size_t count) {
+		std::unique_ptr<Slab> slab(new TypedSlab<T>(count));
+		T* objects = static_cast<TypedSlab<T>*>(slab.get())->objects.get();
+		for (size_t i = 0; i < count; i++)
+			objects[i].setArena(this);
+		std::lock_guard<std::mutex> lock(mutex);
+		slabs.push_back(std::move(slab));
+		return objects;
+	}
+
+	/// Returns a shared pointer to an object inside the arena which keeps the whole arena alive.
+	template <typename T> std::shared_ptr<T> share(T* object) {
+		return std::shared_ptr<T>(shared_from_this(), object);
+	}
+
+	/// Keeps an object alive until the entities are released, for data the entities point into like EXPRESSLazyDecoder.
+	void retain(const std::shared_ptr<void>& object) {
+		std::lock_guard<std::mutex> lock(mutex);
+		retained.push_back(object);
+	}
+
+private:
+	struct Slab {
+		virtual ~Slab() { }
+	};
+
+	template <typename T> struct TypedSlab : public Slab {
+		TypedSlab(size_t count) : objects(new T[count]) { }
+		std::unique_ptr<T[]> objects;
+	};
+
+	// Declared before the slabs, so the retained objects are released after the entities.
+	std::vector<std::shared_ptr<void>> retained;
+	std::vector<std::unique_ptr<Slab>> slabs;
+	std::mutex mutex;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSArena);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSArena_c81e5f3a_4d2b_4f96_8a7e_0b6d93c1e254_h
@@ -25,6 +25,9 @@
 
 #include "EXPRESSType.h"
 #include "EXPRESSModel.h"
+#include "EXPRESSTokenizer.h"
+#include "EXPRESSSnapshot.h"
+#include "EXPRESSStepFormat.h"
 
 #include <string>
 #include <algorithm>
@@ -45,6 +48,15 @@
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
 
+/// REAL, INTEGER and the types derived from them, their elements are parsed directly from the STEP tokens.
+template <typename T, typename = void> struct isNumberType : std::false_type { };
+template <typename T> struct isNumberType<T, typename std::enable_if<
+	std::is_arithmetic<typename T::UnderlyingType>::value && !std::is_same<typename T::UnderlyingType, bool>::value>::type> : std::true_type { };
+
+/// Lists of numbers like IfcCartesianPoint coordinates, lists of them are parsed in bulk.
+template <typename T, typename = void> struct isNumberListType : std::false_type { };
+template <typename T> struct isNumberListType<T, typename std::enable_if<
+	std::is_same<typename T::UnderlyingType, std::vector<typename T::element_type>>::value && isNumberType<typename T::element_type>::value>::type> : std::true_type { };
 
 template <typename ValueType, size_t MinCardinality, size_t MaxCardinality> class EXPRESSContainer : public std::vector<ValueType> {
 	using base = std::vector<ValueType>;
@@ -60,124 +72,112 @@ public:
 
 	//virtual const std::string getStepParameter() const;
 	virtual const std::string getStepParameter() const {
-		std::vector<std::string> params;
-		if (!(this->base::empty())) {
-			std::for_each(this->base::begin(), this->base::end(), [&params](const ValueType& elem) {
-				params.push_back(elem.getStepParameter());
-				params.push_back(",");
-			});
-			params.pop_back();
-		}
-		std::string result = "(";
-		if (!params.empty()) {
-			std::for_each(params.begin(), params.end(), [&result](std::string elem) {
-				result += elem;
-			});
-		}
-		result.append(")");
+		std::string result;
+		writeStepParameter(result);
 		return result;
 	}
 
+	/// Appends the elements to a STEP line without building a string per element.
+	void writeStepParameter(std::string& out) const {
+		out += '(';
+		for (auto it = this->base::begin(); it != this->base::end(); ++it) {
+			if (it != this->base::begin())
+				out += ',';
+			it->writeStepParameter(out);
+		}
+		out += ')';
+	}
+
 	//static std::vector<ValueType> readStepData(const std::string& value, const std::shared_ptr<EXPRESSModel>& model);
-	static std::vector<ValueType> readStepData(const std::string& value, const std::shared_ptr<EXPRESSModel>& model) {
-		// Remove the parentheses
-		auto paramvalue = value.substr(1, value.size() - 2);
-		// Loop over the rest
-		std::string::iterator it = paramvalue.begin();
-		size_t start = 0;
+	static std::vector<ValueType> readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model) {
 		// The result
 		std::vector<ValueType> result;
+		if (value.empty() || value.front() != '(')
+			return result;
 
-		// Amount of open parenthesis
-		size_t nOpenedParenthesis = 0;
-
-		// Loop until the end
-		while (it != paramvalue.end()) {
-
-			// The current position of the iterator
-			auto currentpos = std::distance(paramvalue.begin(), it);
+		readElements(value, model, result, std::integral_constant<int, isNumberType<ValueType>::value ? 1 : isNumberListType<ValueType>::value ? 2 : 0>());
+		return result;
+	}
 
-			// Skip the content of string literal, if some parenthesis were open already
-			// The content of the literal will get managed later in the recursion
-			if (*it == '\''
-				&& nOpenedParenthesis > 0)
-			{
-				auto pos = paramvalue.find_first_of('\'', currentpos + 1);
-				it += pos - currentpos;
-				continue;
-			}
+	void link(const EXPRESSModel& model, std::vector<size_t>& unresolved) {
+		for (auto& elem : *this)
+			elem.link(model, unresolved);
+	}
 
-			// React according to the character in question
-			switch (*it)
-			{
-			case ' ':
-			{
-				// ignore outside a string literal
-				it++;
-				continue;
-			}
-			case '(':
-			{
-				// count up
-				nOpenedParenthesis++;
-				// Remeber position, if first
-				if (nOpenedParenthesis == 1)
-					start = currentpos;
-				it++;
-				continue;
-			}
-			case ')':
-			{
-				// count down
-				nOpenedParenthesis--;
-			}
-			} // end switch (*it)
-
-			// Two cases:
-			//  -> if it is just a simple container
-			//       i.e. (aa,bb,cc) - the out-most parenthesis were already removed, so we are dealing with aa,bb,cc
-			//       <start - our position>                                                                  x          (start = our position)
-			//       or                                                                                         x
-			//  -> or we have finished with one element within the container
-			//       i.e. ((a,b),(c,d)) - again, the out-most parenthesis were removed already -> (a,b),(c,d)
-			//       <start - our position>                                                       <   >
-			//       or																					<   >
-			if (nOpenedParenthesis == 0)
-			{
-				// find the first comma that follows
-				auto pos = paramvalue.find_first_of(',', currentpos + 1);
-				// if none found -> take the end
-				if (pos == std::string::npos)
-					pos = paramvalue.size();
-
-				// Interpret the value
-				ValueType type;
-				std::string sub = paramvalue.substr(start, pos-start);
-				type = ValueType::readStepData(sub, model);
-				result.push_back(type);
-
-				// Continue along the string, skip the sub
-				auto len = pos - currentpos;
-				// if we are in the middle of a list, count 1 more to skip the comma
-				if ( it + len != paramvalue.end() )
-					len += 1;
-				// count up
-				it += len;
-				start += len;
-				continue;
-			}
+	template <typename F> void forEachReference(const F& f) const {
+		for (const auto& elem : *this)
+			elem.forEachReference(f);
+	}
 
-			// go to next char
-			it++;
-		}
+	/// Containers are stored with a leading element count.
+	void writeSnapshot(EXPRESSSnapshotWriter& out) const {
+		out.write(static_cast<uint64_t>(this->size()));
+		for (const auto& elem : *this)
+			elem.writeSnapshot(out);
+	}
 
-		return result;
+	void readSnapshot(EXPRESSSnapshotReader& in) {
+		// Every element takes at least one byte, larger counts can only come from a damaged snapshot.
+		const uint64_t size = in.next<uint64_t>();
+		if (size > in.remaining())
+			throw std::runtime_error("Snapshot contains an invalid container size.");
+		this->resize(size);
+		for (auto& elem : *this)
+			elem.readSnapshot(in);
 	}
 
 	friend void swap(EXPRESSContainer& first, EXPRESSContainer& second)
 	{		
 		first.base::swap(second);
 	}
+
+private:
+	static void readElements(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model, std::vector<ValueType>& result, std::integral_constant<int, 0>) {
+		// Split the list in a single pass, nested lists and string literals are kept together and interpreted in the recursion.
+		// The elements are read from their tokens, see ValueType::readStepData.
+		EXPRESSTokenizer::forEachElement(value.data(), value.data() + value.size(), [&result, &model](EXPRESSTokenizer::token element) {
+			ValueType type;
+			type = ValueType::readStepData(element, model);
+			result.push_back(type);
+		});
+	}
+
+	static void readElements(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model, std::vector<ValueType>& result, std::integral_constant<int, 1>) {
+		// Numbers are parsed from the tokens without a detour through std::string
+		EXPRESSTokenizer::forEachElement(value.data(), value.data() + value.size(), [&result, &model](EXPRESSTokenizer::token element) {
+			ValueType type;
+			const char* it = element.data();
+			double number = 0.0;
+			if (EXPRESSTokenizer::parseNumber(it, element.data() + element.size(), number) && it == element.data() + element.size())
+				type = static_cast<typename ValueType::UnderlyingType>(number);
+			else
+				type = ValueType::readStepData(element, model);
+			result.push_back(type);
+		});
+	}
+
+	static void readElements(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model, std::vector<ValueType>& result, std::integral_constant<int, 2>) {
+		typedef typename ValueType::element_type NumberType;
+
+		// All numbers of the nested lists are parsed into one buffer first, the elements are then built with the final sizes
+		thread_local std::vector<double> numbers;
+		thread_local std::vector<size_t> lengths;
+		if (!EXPRESSTokenizer::readNumberLists(value, numbers, lengths)) {
+			readElements(value, model, result, std::integral_constant<int, 0>());
+			return;
+		}
+
+		result.resize(lengths.size());
+		const double* number = numbers.data();
+		for (size_t i = 0; i < lengths.size(); i++) {
+			result[i].reserve(lengths[i]);
+			for (size_t k = 0; k < lengths[i]; k++) {
+				NumberType type;
+				type = static_cast<typename NumberType::UnderlyingType>(*number++);
+				result[i].push_back(type);
+			}
+		}
+	}
 };
 
 template <size_t MinCardinality, size_t MaxCardinality, typename T> using LIST = EXPRESSContainer<T, MinCardinality, MaxCardinality>;
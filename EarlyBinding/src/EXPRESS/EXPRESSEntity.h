@@ -25,15 +25,41 @@
 
 #include "EXPRESSObject.h"
 
+#include <atomic>
+#include <cstdint>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
 
+class EXPRESSModel;
+class EXPRESSArena;
+class EXPRESSEntity;
+class EXPRESSSnapshotWriter;
+class EXPRESSSnapshotReader;
+class EXPRESSInverseCollector;
+
+/// Undecoded attributes of an entity read in lazy mode, see EXPRESSLazyDecoder.
+class EXPRESSLazyAttributes {
+public:
+	virtual void decode(EXPRESSEntity& entity) const = 0;
+
+protected:
+	~EXPRESSLazyAttributes() { }
+};
 
 class EXPRESSEntity : public EXPRESSObject {
 public:
+	EXPRESSEntity() = default;
+	EXPRESSEntity(const EXPRESSEntity& other) : m_id(other.m_id) { }
+
+	EXPRESSEntity& operator=(const EXPRESSEntity& other) {
+		m_id = other.m_id;
+		return *this;
+	}
+
 	const size_t getId() const {
 		return m_id;
 	}
@@ -52,10 +78,62 @@ public:
 
 	virtual const std::string classname() const = 0;
 
+	/// Id of the generated entity type, dense within its schema. See isOfType and entityCast.
+	virtual uint32_t typeId() const {
+		return noTypeId;
+	}
+
+	static const uint32_t noTypeId = 0xffffffffu;
+
 	virtual const std::string getStepLine() const = 0;
 
+	/// Appends the statement of the entity without the terminating semicolon, EXPRESSStepWriter reuses one buffer per thread.
+	virtual void writeStepLine(std::string& out) const {
+		out += getStepLine();
+	}
+
+	/// Resolves the references of all attributes against the model, ids which cannot be resolved are appended to unresolved.
+	virtual void linkReferences(const EXPRESSModel& model, std::vector<size_t>& unresolved) { }
+
+	/// Writes and reads the attributes in the binary layout of the generated class, see EXPRESSSnapshotFile.
+	virtual void writeSnapshot(EXPRESSSnapshotWriter& out) const { }
+
+	virtual void readSnapshot(EXPRESSSnapshotReader& in) { }
+
+	/// Reports the references held by attributes with an INVERSE counterpart, see EXPRESSInverseIndex.
+	virtual void collectInverseReferences(EXPRESSInverseCollector& collector) const { }
+
+	/// Decodes the attributes of an entity read in lazy mode on first access. References call it before they hand out
+	/// the entity, entities taken from EXPRESSModel::entities directly have to be decoded before their attributes are used.
+	void decode() const {
+		const EXPRESSLazyAttributes* attributes = m_lazyAttributes.load(std::memory_order_acquire);
+		if (attributes != nullptr)
+			attributes->decode(const_cast<EXPRESSEntity&>(*this));
+	}
+
+	const EXPRESSLazyAttributes* getLazyAttributes() const {
+		return m_lazyAttributes.load(std::memory_order_acquire);
+	}
+
+	void setLazyAttributes(const EXPRESSLazyAttributes* attributes) {
+		m_lazyAttributes.store(attributes, std::memory_order_release);
+	}
+
+	/// The arena the entity was allocated in, which owns it. Null for entities created outside of a model.
+	EXPRESSArena* getArena() const {
+		return m_arena;
+	}
+
+	void setArena(EXPRESSArena* arena) {
+		m_arena = arena;
+	}
+
 protected:
 	size_t m_id;
+
+private:
+	std::atomic<const EXPRESSLazyAttributes*> m_lazyAttributes{ nullptr };
+	EXPRESSArena* m_arena = nullptr;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
@@ -0,0 +1,80 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSEntityCast_42764f4d_7597_46f7_8607_100a8ef525c0_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSEntityCast_42764f4d_7597_46f7_8607_100a8ef525c0_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+
+#include <memory>
+#include <type_traits>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// The ExpressBindingGenerator numbers the entity types of a schema in preorder of the inheritance tree, the subtypes
+/// of a type T have the ids T::TypeId to T::TypeId + T::SubtypeCount - 1. Testing for a type is therefore one virtual
+/// call and one comparison, without RTTI.
+template <typename T> bool isOfType(const EXPRESSEntity& entity) {
+	return entity.typeId() - T::TypeId < T::SubtypeCount;
+}
+
+namespace detail {
+	template <typename T, typename E> using is_generated_cast = std::integral_constant<bool,
+		std::is_base_of<EXPRESSEntity, T>::value && std::is_base_of<EXPRESSEntity, E>::value>;
+
+	template <typename T, typename E> bool isOfType(const std::shared_ptr<E>& entity, std::true_type) {
+		return entity && OpenInfraPlatform::EarlyBinding::isOfType<T>(*entity);
+	}
+
+	template <typename T, typename E> bool isOfType(const std::shared_ptr<E>& entity, std::false_type) {
+		return std::dynamic_pointer_cast<T>(entity) != nullptr;
+	}
+
+	template <typename T, typename E> std::shared_ptr<T> entityCast(const std::shared_ptr<E>& entity, std::true_type) {
+		if (!entity || !OpenInfraPlatform::EarlyBinding::isOfType<T>(*entity))
+			return nullptr;
+		// Generated entities derive from EXPRESSEntity through single inheritance only, so the static down cast is exact.
+		return std::shared_ptr<T>(entity, static_cast<T*>(static_cast<EXPRESSEntity*>(entity.get())));
+	}
+
+	template <typename T, typename E> std::shared_ptr<T> entityCast(const std::shared_ptr<E>& entity, std::false_type) {
+		return std::dynamic_pointer_cast<T>(entity);
+	}
+}
+
+/// Returns true if the entity is not empty and of type T or one of its subtypes.
+template <typename T, typename E> bool isOfType(const std::shared_ptr<E>& entity) {
+	return detail::isOfType<T>(entity, detail::is_generated_cast<T, E>());
+}
+
+/// Replaces std::dynamic_pointer_cast for generated entities. The reference count is only touched if the entity is of
+/// type T, other classes fall back to std::dynamic_pointer_cast.
+template <typename T, typename E> std::shared_ptr<T> entityCast(const std::shared_ptr<E>& entity) {
+	return detail::entityCast<T>(entity, detail::is_generated_cast<T, E>());
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(isOfType);
+EMBED_INTO_OIP_NAMESPACE(entityCast);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSEntityCast_42764f4d_7597_46f7_8607_100a8ef525c0_h
@@ -0,0 +1,275 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSEntityStore_9b4f2a6c_7e13_4d85_a0c2_5f8e1d3b6a97_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSEntityStore_9b4f2a6c_7e13_4d85_a0c2_5f8e1d3b6a97_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Allocates the entities of a model read in lazy mode on first access, see EXPRESSLazyDecoder. The reader inserts the
+/// ids without entities, the store asks the loader for an entity before it hands it out.
+class EXPRESSEntityLoader {
+public:
+	/// Allocates the entity with the id, if it is not yet allocated, and places it in the store. May be called from
+	/// several threads.
+	virtual void load(size_t id) = 0;
+
+	/// Allocates all entities which are not yet allocated.
+	virtual void loadAll() = 0;
+
+protected:
+	~EXPRESSEntityLoader() { }
+};
+
+/// Entities of a model indexed by their STEP instance id.
+/// STEP ids are nearly dense, so they directly index a slot array. Ids far beyond the number of entities are kept
+/// in an ordered overflow map. The interface follows std::map<size_t, std::shared_ptr<EXPRESSEntity>>, iteration
+/// visits the dense ids and then the overflow ids, so all entities are visited in ascending order of their ids.
+class EXPRESSEntityStore {
+public:
+	typedef size_t key_type;
+	typedef std::shared_ptr<EXPRESSEntity> mapped_type;
+	typedef std::pair<size_t, mapped_type> value_type;
+	typedef size_t size_type;
+
+private:
+	typedef std::map<size_t, value_type> Overflow;
+
+public:
+	template <typename Store, typename Value, typename OverflowIterator> class basic_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef EXPRESSEntityStore::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Value* pointer;
+		typedef Value& reference;
+
+		basic_iterator() = default;
+		basic_iterator(Store* store, size_t position, OverflowIterator overflow)
+			: store(store), position(position), overflow(overflow) { skipEmpty(); }
+
+		reference operator*() const { return position < store->slots.size() ? store->slots[position] : overflow->second; }
+		pointer operator->() const { return &**this; }
+
+		basic_iterator& operator++() {
+			if (position < store->slots.size())
+				++position;
+			else
+				++overflow;
+			skipEmpty();
+			return *this;
+		}
+		basic_iterator operator++(int) { basic_iterator old = *this; ++(*this); return old; }
+
+		bool operator==(const basic_iterator& other) const { return position == other.position && overflow == other.overflow; }
+		bool operator!=(const basic_iterator& other) const { return !(*this == other); }
+
+	private:
+		void skipEmpty() {
+			while (position < store->slots.size() && store->slots[position].first == npos)
+				++position;
+		}
+
+		Store* store = nullptr;
+		size_t position = 0;
+		OverflowIterator overflow;
+	};
+
+	typedef basic_iterator<EXPRESSEntityStore, value_type, Overflow::iterator> iterator;
+	typedef basic_iterator<const EXPRESSEntityStore, const value_type, Overflow::const_iterator> const_iterator;
+
+	EXPRESSEntityStore() = default;
+	EXPRESSEntityStore(const EXPRESSEntityStore&) = delete;
+	EXPRESSEntityStore& operator=(const EXPRESSEntityStore&) = delete;
+
+	iterator begin() { loadAll(); return iterator(this, 0, overflow.begin()); }
+	iterator end() { return iterator(this, slots.size(), overflow.end()); }
+	const_iterator begin() const { loadAll(); return const_iterator(this, 0, overflow.begin()); }
+	const_iterator end() const { return const_iterator(this, slots.size(), overflow.end()); }
+
+	size_type size() const { return entityCount; }
+	bool empty() const { return entityCount == 0; }
+
+	void clear() {
+		slots.clear();
+		overflow.clear();
+		claims.reset();
+		loader = nullptr;
+		entityCount = 0;
+	}
+
+	size_type count(size_t id) const { return slotOf(id) != nullptr ? 1 : 0; }
+
+	iterator find(size_t id) {
+		load(id);
+		if (id < slots.size())
+			return slots[id].first != npos ? iterator(this, id, overflow.begin()) : end();
+		return iterator(this, slots.size(), overflow.find(id));
+	}
+
+	const_iterator find(size_t id) const {
+		load(id);
+		if (id < slots.size())
+			return slots[id].first != npos ? const_iterator(this, id, overflow.begin()) : end();
+		return const_iterator(this, slots.size(), overflow.find(id));
+	}
+
+	/// Returns the entity or an empty pointer without inserting anything.
+	const mapped_type& get(size_t id) const {
+		static const mapped_type none;
+		load(id);
+		const value_type* slot = slotOf(id);
+		return slot != nullptr ? slot->second : none;
+	}
+
+	mapped_type& operator[](size_t id) {
+		return insert(value_type(id, nullptr)).first->second;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value) {
+		const size_t id = value.first;
+		load(id);
+		if (id >= slots.size() && id < denseLimit(entityCount + 1))
+			growDense(std::max(id + 1, slots.size() + slots.size() / 2));
+
+		if (id < slots.size()) {
+			if (slots[id].first != npos)
+				return std::make_pair(iterator(this, id, overflow.begin()), false);
+			slots[id] = value;
+			entityCount++;
+			return std::make_pair(iterator(this, id, overflow.begin()), true);
+		}
+
+		auto inserted = overflow.insert(std::make_pair(id, value));
+		if (inserted.second)
+			entityCount++;
+		return std::make_pair(iterator(this, slots.size(), inserted.first), inserted.second);
+	}
+
+	/// Prepares the store for concurrent insertion of the given number of entities with ids up to maxId, until
+	/// endConcurrentInsertion() is called.
+	void reserve(size_t maxId, size_t entities) {
+		growDense(std::min(maxId + 1, denseLimit(entities)));
+		claims.reset(new std::atomic<bool>[slots.size()]);
+		for (size_t i = 0; i < slots.size(); i++)
+			claims[i].store(false, std::memory_order_relaxed);
+	}
+
+	/// Inserts an entity and may be called from several threads after reserve(). Dense ids are inserted lock-free,
+	/// only ids in the overflow are serialized. Returns false if the id is already taken.
+	bool insertConcurrent(size_t id, const mapped_type& entity) {
+		if (claims && id < slots.size()) {
+			if (claims[id].exchange(true, std::memory_order_acq_rel) || slots[id].first != npos)
+				return false;
+			slots[id] = value_type(id, entity);
+			entityCount++;
+			return true;
+		}
+
+		std::lock_guard<std::mutex> lock(overflowMutex);
+		return insert(value_type(id, entity)).second;
+	}
+
+	/// Ends the concurrent insertion started by reserve(). The claims are released, they take a byte per slot
+	/// for the lifetime of the model otherwise.
+	void endConcurrentInsertion() {
+		claims.reset();
+	}
+
+	/// Sets the loader of the entities that were inserted without entity. Null once all entities are allocated or
+	/// the entities which are not yet allocated are dropped, like in the destructor of the model.
+	void setLoader(EXPRESSEntityLoader* loader) {
+		this->loader = loader;
+	}
+
+	/// Places the entity allocated by the loader for an id that was inserted without entity. May be called from
+	/// several threads for distinct ids.
+	void place(size_t id, const mapped_type& entity) {
+		value_type* slot = const_cast<value_type*>(slotOf(id));
+		if (slot != nullptr)
+			slot->second = entity;
+	}
+
+private:
+	static const size_t npos = static_cast<size_t>(-1);
+	static const size_t minimumDenseSize = 1 << 16;
+
+	/// Ids up to four times the number of entities are stored dense.
+	static size_t denseLimit(size_t entities) { return 4 * entities + minimumDenseSize; }
+
+	void growDense(size_t size) {
+		if (size <= slots.size())
+			return;
+
+		// A copy, binding npos itself to the pair constructor would need a definition outside of the class.
+		const size_t empty = npos;
+		slots.resize(size, value_type(empty, nullptr));
+		claims.reset();
+
+		// Move overflow entries that are now covered by the dense range, they are the smallest ids of the overflow.
+		const auto covered = overflow.lower_bound(slots.size());
+		for (auto it = overflow.begin(); it != covered; ++it)
+			slots[it->first] = std::move(it->second);
+		overflow.erase(overflow.begin(), covered);
+	}
+
+	void load(size_t id) const {
+		if (loader != nullptr)
+			loader->load(id);
+	}
+
+	void loadAll() const {
+		if (loader != nullptr)
+			loader->loadAll();
+	}
+
+	const value_type* slotOf(size_t id) const {
+		if (id < slots.size())
+			return slots[id].first != npos ? &slots[id] : nullptr;
+		auto it = overflow.find(id);
+		return it != overflow.end() ? &it->second : nullptr;
+	}
+
+	std::vector<value_type> slots;
+	Overflow overflow;
+	std::unique_ptr<std::atomic<bool>[]> claims;
+	std::mutex overflowMutex;
+	std::atomic<size_t> entityCount{ 0 };
+	EXPRESSEntityLoader* loader = nullptr;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSEntityStore);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSEntityStore_9b4f2a6c_7e13_4d85_a0c2_5f8e1d3b6a97_h
@@ -0,0 +1,178 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSExtents_454b8719_c912_4c37_bef1_04bbc017e173_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSExtents_454b8719_c912_4c37_bef1_04bbc017e173_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <boost/utility/string_view.hpp>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Subtype relation of the entity types of a schema, generated by the ExpressBindingGenerator. Every entity type, abstract
+/// or not, is mapped to the non-abstract types which are the type itself or one of its subtypes. Non-abstract types are
+/// numbered in the order of the type table of the reader.
+class EXPRESSSubtypeTable {
+public:
+	/// names holds the upper-case names of all entity types in ascending order, the concrete subtypes of names[i] are
+	/// subtypes[offsets[i]] to subtypes[offsets[i + 1]].
+	EXPRESSSubtypeTable(const char* const* names, size_t count, const size_t* offsets, const uint32_t* subtypes)
+		: names(names), count(count), offsets(offsets), subtypes(subtypes) { }
+
+	/// Returns the index of the entity type, the name is compared case-insensitive. Returns -1 if the name is unknown.
+	int find(boost::string_view name) const {
+		const char* const* it = std::lower_bound(names, names + count, name, [](const char* entry, boost::string_view name) { return compare(entry, name) < 0; });
+		return (it != names + count && compare(*it, name) == 0) ? static_cast<int>(it - names) : -1;
+	}
+
+	const uint32_t* subtypesBegin(int type) const { return type >= 0 ? subtypes + offsets[type] : subtypes; }
+	const uint32_t* subtypesEnd(int type) const { return type >= 0 ? subtypes + offsets[type + 1] : subtypes; }
+
+private:
+	static int compare(const char* entry, boost::string_view name) {
+		for (const char c : name) {
+			const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+			if (*entry != upper)
+				return *entry == '\0' || *entry < upper ? -1 : 1;
+			++entry;
+		}
+		return *entry == '\0' ? 0 : 1;
+	}
+
+	const char* const* names;
+	const size_t count;
+	const size_t* offsets;
+	const uint32_t* subtypes;
+};
+
+/// Ids of the entities of a model grouped by their type. The ids of each non-abstract type are stored contiguously in
+/// ascending order, the instances of a type and all of its subtypes are the concatenation of the extents of its
+/// concrete subtypes. Selecting entities by type needs neither a pass over all entities nor RTTI.
+class EXPRESSExtents {
+public:
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef size_t value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const size_t* pointer;
+		typedef const size_t& reference;
+
+		const_iterator() = default;
+		const_iterator(const EXPRESSExtents* extents, const uint32_t* type, const uint32_t* typeEnd)
+			: extents(extents), type(type), typeEnd(typeEnd), position(type != typeEnd ? extents->offsets[*type] : 0) {
+			skipEmpty();
+		}
+
+		reference operator*() const { return extents->ids[position]; }
+		pointer operator->() const { return &extents->ids[position]; }
+
+		const_iterator& operator++() { ++position; skipEmpty(); return *this; }
+		const_iterator operator++(int) { const_iterator old = *this; ++(*this); return old; }
+
+		bool operator==(const const_iterator& other) const { return type == other.type && position == other.position; }
+		bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+	private:
+		void skipEmpty() {
+			while (type != typeEnd && position == extents->offsets[*type + 1]) {
+				++type;
+				position = type != typeEnd ? extents->offsets[*type] : 0;
+			}
+		}
+
+		const EXPRESSExtents* extents = nullptr;
+		const uint32_t* type = nullptr;
+		const uint32_t* typeEnd = nullptr;
+		size_t position = 0;
+	};
+
+	/// The ids of the entities of a type and its subtypes.
+	class Range {
+	public:
+		Range(const EXPRESSExtents* extents, const uint32_t* typeBegin, const uint32_t* typeEnd)
+			: extents(extents), typeBegin(typeBegin), typeEnd(typeEnd) { }
+
+		const_iterator begin() const { return const_iterator(extents, typeBegin, typeEnd); }
+		const_iterator end() const { return const_iterator(extents, typeEnd, typeEnd); }
+
+		size_t size() const {
+			size_t size = 0;
+			for (const uint32_t* type = typeBegin; type != typeEnd; ++type)
+				size += extents->offsets[*type + 1] - extents->offsets[*type];
+			return size;
+		}
+
+		bool empty() const { return begin() == end(); }
+
+	private:
+		const EXPRESSExtents* extents;
+		const uint32_t* typeBegin;
+		const uint32_t* typeEnd;
+	};
+
+	EXPRESSExtents() = default;
+
+	/// indicesByType holds the indices of the entities of each non-abstract type, idOf(index) returns the STEP id.
+	template <typename IdOf> EXPRESSExtents(const EXPRESSSubtypeTable& subtypes, const std::vector<std::vector<size_t>>& indicesByType, IdOf idOf)
+		: subtypes(&subtypes), offsets(indicesByType.size() + 1, 0) {
+		for (size_t type = 0; type < indicesByType.size(); type++)
+			offsets[type + 1] = offsets[type] + indicesByType[type].size();
+
+		ids.resize(offsets.back());
+		#pragma omp parallel for schedule(dynamic)
+		for (long type = 0; type < indicesByType.size(); type++) {
+			const auto first = ids.begin() + offsets[type];
+			std::transform(indicesByType[type].begin(), indicesByType[type].end(), first, idOf);
+			std::sort(first, first + indicesByType[type].size());
+		}
+	}
+
+	/// Returns the ids of all entities of the type or one of its subtypes, the name is compared case-insensitive.
+	/// The range is empty for unknown types.
+	Range of(boost::string_view type) const {
+		if (subtypes == nullptr)
+			return Range(this, nullptr, nullptr);
+		const int index = subtypes->find(type);
+		return Range(this, subtypes->subtypesBegin(index), subtypes->subtypesEnd(index));
+	}
+
+	/// Total number of entities in the extents.
+	size_t size() const { return ids.size(); }
+
+private:
+	const EXPRESSSubtypeTable* subtypes = nullptr;
+	std::vector<size_t> offsets;
+	std::vector<size_t> ids;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSSubtypeTable);
+EMBED_INTO_OIP_NAMESPACE(EXPRESSExtents);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSExtents_454b8719_c912_4c37_bef1_04bbc017e173_h
@@ -0,0 +1,258 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSInverseIndex_3b7f1c92_6e4d_4a85_b0d3_94c2e8a1f567_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSInverseIndex_3b7f1c92_6e4d_4a85_b0d3_94c2e8a1f567_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+#include "EXPRESSEntityStore.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// A reference from an entity to the entity it is stored for in EXPRESSInverseIndex. The relation identifies the
+/// attribute, it is numbered by the generator over all attributes that are the target of an INVERSE attribute.
+struct EXPRESSInverseEdge {
+	EXPRESSEntity* source;
+	uint32_t relation;
+};
+
+/// Passed to EXPRESSEntity::collectInverseReferences, the generated entities add their attributes with the relation
+/// number of each attribute.
+class EXPRESSInverseCollector {
+public:
+	struct Reference {
+		size_t target;
+		EXPRESSInverseEdge edge;
+	};
+
+	EXPRESSInverseCollector(EXPRESSEntity& source, std::vector<Reference>& references) : source(source), references(references) { }
+
+	template <typename T> void add(uint32_t relation, const T& attribute) {
+		attribute.forEachReference([this, relation](size_t target) {
+			references.push_back(Reference{ target, EXPRESSInverseEdge{ &source, relation } });
+		});
+	}
+
+private:
+	EXPRESSEntity& source;
+	std::vector<Reference>& references;
+};
+
+/// The entities referencing an entity through one relation, the result of an inverse attribute.
+template <typename T> class EXPRESSInverseRange {
+public:
+	class iterator {
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* pointer;
+		typedef T& reference;
+
+		iterator(const EXPRESSInverseEdge* edge = nullptr) : edge(edge) { }
+
+		reference operator*() const { return static_cast<T&>(*edge->source); }
+		pointer operator->() const { return &**this; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		iterator& operator++() { ++edge; return *this; }
+		iterator operator++(int) { iterator old = *this; ++edge; return old; }
+		iterator& operator--() { --edge; return *this; }
+		iterator operator--(int) { iterator old = *this; --edge; return old; }
+		iterator& operator+=(difference_type n) { edge += n; return *this; }
+		iterator& operator-=(difference_type n) { edge -= n; return *this; }
+		iterator operator+(difference_type n) const { return iterator(edge + n); }
+		iterator operator-(difference_type n) const { return iterator(edge - n); }
+		difference_type operator-(const iterator& other) const { return edge - other.edge; }
+
+		bool operator==(const iterator& other) const { return edge == other.edge; }
+		bool operator!=(const iterator& other) const { return edge != other.edge; }
+		bool operator<(const iterator& other) const { return edge < other.edge; }
+
+	private:
+		const EXPRESSInverseEdge* edge;
+	};
+
+	EXPRESSInverseRange() = default;
+	EXPRESSInverseRange(const EXPRESSInverseEdge* first, const EXPRESSInverseEdge* last) : first(first), last(last) { }
+
+	iterator begin() const { return iterator(first); }
+	iterator end() const { return iterator(last); }
+
+	size_t size() const { return last - first; }
+	bool empty() const { return first == last; }
+	T& operator[](size_t index) const { return begin()[index]; }
+
+private:
+	const EXPRESSInverseEdge* first = nullptr;
+	const EXPRESSInverseEdge* last = nullptr;
+};
+
+/// Entities referencing each entity, the counterpart of the INVERSE attributes of the schema. The references are
+/// collected in parallel and stored as compressed sparse rows: an offset per referenced entity into one array of
+/// edges, which are sorted by relation and id of the referencing entity. A lookup takes time in the number of edges
+/// of the entity. Referenced ids are mapped to rows directly up to four times the number of entities, larger ids are
+/// mapped by binary search, like in EXPRESSEntityStore.
+class EXPRESSInverseIndex {
+public:
+	explicit EXPRESSInverseIndex(const EXPRESSEntityStore& entities) {
+		std::vector<EXPRESSEntity*> sources;
+		sources.reserve(entities.size());
+		for (const auto& entry : entities) {
+			if (entry.second)
+				sources.push_back(entry.second.get());
+		}
+
+		int threadCount = 1;
+#ifdef _OPENMP
+		threadCount = omp_get_max_threads();
+#endif
+		std::vector<std::vector<EXPRESSInverseCollector::Reference>> collected(threadCount);
+		// Lazy entities are decoded while their references are collected, the first error is rethrown after the loop.
+		std::exception_ptr error;
+		#pragma omp parallel
+		{
+			int thread = 0;
+#ifdef _OPENMP
+			thread = omp_get_thread_num();
+#endif
+			std::vector<EXPRESSInverseCollector::Reference>& references = collected[thread];
+			#pragma omp for schedule(dynamic, 256)
+			for (long i = 0; i < static_cast<long>(sources.size()); i++) {
+				try {
+					EXPRESSInverseCollector collector(*sources[i], references);
+					sources[i]->collectInverseReferences(collector);
+				}
+				catch (...) {
+					#pragma omp critical
+					if (!error)
+						error = std::current_exception();
+				}
+			}
+		}
+		if (error)
+			std::rethrow_exception(error);
+
+		size_t count = 0;
+		size_t maxTarget = 0;
+		for (const auto& references : collected) {
+			count += references.size();
+			for (const auto& reference : references)
+				maxTarget = std::max(maxTarget, reference.target);
+		}
+		if (count > std::numeric_limits<uint32_t>::max())
+			throw std::runtime_error("Too many references for the inverse index.");
+
+		denseSize = count != 0 ? std::min(maxTarget + 1, 4 * entities.size() + minimumDenseSize) : 0;
+		for (const auto& references : collected) {
+			for (const auto& reference : references) {
+				if (reference.target >= denseSize)
+					sparseTargets.push_back(reference.target);
+			}
+		}
+		std::sort(sparseTargets.begin(), sparseTargets.end());
+		sparseTargets.erase(std::unique(sparseTargets.begin(), sparseTargets.end()), sparseTargets.end());
+
+		// Counting sort of the references by row.
+		offsets.assign(denseSize + sparseTargets.size() + 1, 0);
+		for (const auto& references : collected) {
+			for (const auto& reference : references)
+				offsets[rowOf(reference.target) + 1]++;
+		}
+		for (size_t row = 1; row < offsets.size(); row++)
+			offsets[row] += offsets[row - 1];
+
+		edges.resize(count);
+		std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+		for (auto& references : collected) {
+			for (const auto& reference : references)
+				edges[next[rowOf(reference.target)]++] = reference.edge;
+			std::vector<EXPRESSInverseCollector::Reference>().swap(references);
+		}
+
+		#pragma omp parallel for schedule(dynamic, 4096)
+		for (long row = 0; row < static_cast<long>(offsets.size()) - 1; row++) {
+			if (offsets[row + 1] - offsets[row] > 1) {
+				std::sort(edges.begin() + offsets[row], edges.begin() + offsets[row + 1], [](const EXPRESSInverseEdge& lhs, const EXPRESSInverseEdge& rhs) {
+					return lhs.relation != rhs.relation ? lhs.relation < rhs.relation : lhs.source->getId() < rhs.source->getId();
+				});
+			}
+		}
+	}
+
+	EXPRESSInverseIndex(const EXPRESSInverseIndex&) = delete;
+	EXPRESSInverseIndex& operator=(const EXPRESSInverseIndex&) = delete;
+
+	/// Returns the entities referencing the entity with the given id through the relation, T is the type of the
+	/// entity declaring the referencing attribute.
+	template <typename T> EXPRESSInverseRange<T> find(size_t target, uint32_t relation) const {
+		const size_t row = rowOf(target);
+		if (row == npos)
+			return EXPRESSInverseRange<T>();
+
+		const EXPRESSInverseEdge* first = edges.data() + offsets[row];
+		const EXPRESSInverseEdge* last = edges.data() + offsets[row + 1];
+		first = std::lower_bound(first, last, relation, [](const EXPRESSInverseEdge& edge, uint32_t relation) { return edge.relation < relation; });
+		last = std::upper_bound(first, last, relation, [](uint32_t relation, const EXPRESSInverseEdge& edge) { return relation < edge.relation; });
+		return EXPRESSInverseRange<T>(first, last);
+	}
+
+	/// The number of references in the index.
+	size_t size() const { return edges.size(); }
+
+private:
+	static const size_t npos = static_cast<size_t>(-1);
+	static const size_t minimumDenseSize = 1 << 16;
+
+	size_t rowOf(size_t target) const {
+		if (target < denseSize)
+			return target;
+		auto it = std::lower_bound(sparseTargets.begin(), sparseTargets.end(), target);
+		return it != sparseTargets.end() && *it == target ? denseSize + (it - sparseTargets.begin()) : npos;
+	}
+
+	size_t denseSize = 0;
+	std::vector<size_t> sparseTargets;
+	std::vector<uint32_t> offsets;
+	std::vector<EXPRESSInverseEdge> edges;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSInverseEdge);
+EMBED_INTO_OIP_NAMESPACE(EXPRESSInverseCollector);
+EMBED_INTO_OIP_NAMESPACE(EXPRESSInverseIndex);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSInverseIndex_3b7f1c92_6e4d_4a85_b0d3_94c2e8a1f567_h
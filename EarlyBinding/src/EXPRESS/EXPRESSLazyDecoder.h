@@ -0,0 +1,199 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSLazyDecoder_47d2e9b1_8c06_4f3a_9e5d_a1b7c3f60e28_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSLazyDecoder_47d2e9b1_8c06_4f3a_9e5d_a1b7c3f60e28_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+#include "EXPRESSModel.h"
+#include "EXPRESSArena.h"
+#include "EXPRESSMappedFile.h"
+#include "EXPRESSTokenizer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Allocates and decodes the entities read in lazy mode on first access. The reader only indexes the file and inserts
+/// the ids into the model, the decoder remembers the statement of each entity, which stays inside the memory mapped
+/// file. All entities of a type are allocated in one slab when the first of them is accessed, their attributes are
+/// decoded when they are used. The decoder is retained by the arena of the model and keeps the mapping alive, so the
+/// statements stay valid as long as any entity. Entities that outlive their model cannot resolve references anymore,
+/// decoding them throws.
+class EXPRESSLazyDecoder : public EXPRESSEntityLoader {
+public:
+	typedef void(*Allocator)(EXPRESSArena&, const std::vector<size_t>&, std::vector<std::shared_ptr<EXPRESSEntity>>&);
+	typedef void(*Reader)(EXPRESSEntity&, const std::vector<EXPRESSTokenizer::token>&, const std::shared_ptr<EXPRESSModel>&);
+
+	/// The ids of the instances must already be inserted into the model without entity. allocators and readers are
+	/// indexed by type and must outlive the decoder.
+	EXPRESSLazyDecoder(const std::shared_ptr<EXPRESSMappedFile>& file, const std::shared_ptr<EXPRESSModel>& model,
+		const std::vector<EXPRESSTokenizer::Instance>& instances, const std::vector<std::vector<size_t>>& instancesByType,
+		const Allocator* allocators, const Reader* readers)
+		: file(file), model(model), arena(*model->arena), store(model->entities), allocators(allocators), readers(readers),
+		pending(instancesByType.size()), statements(instancesByType.size()), allocated(new std::once_flag[instancesByType.size()]) {
+		size_t maxId = 0;
+		for (const auto& instance : instances)
+			maxId = std::max(maxId, instance.id);
+		// Like the store, nearly dense ids are looked up directly, others by binary search.
+		if (maxId < 4 * instances.size() + (1 << 16))
+			denseTypes.assign(maxId + 1, -1);
+
+		for (size_t type = 0; type < instancesByType.size(); type++) {
+			pending[type].reserve(instancesByType[type].size());
+			for (const size_t index : instancesByType[type]) {
+				pending[type].push_back(Pending{ instances[index].id, instances[index].statement });
+				if (!denseTypes.empty())
+					denseTypes[instances[index].id] = static_cast<int32_t>(type);
+				else
+					sparseTypes.push_back(std::make_pair(instances[index].id, static_cast<int32_t>(type)));
+			}
+		}
+		std::sort(sparseTypes.begin(), sparseTypes.end());
+	}
+
+	EXPRESSLazyDecoder(const EXPRESSLazyDecoder&) = delete;
+	EXPRESSLazyDecoder& operator=(const EXPRESSLazyDecoder&) = delete;
+
+	virtual void load(size_t id) override {
+		const int32_t type = typeOf(id);
+		if (type >= 0)
+			allocate(type);
+	}
+
+	virtual void loadAll() override {
+		if (allAllocated)
+			return;
+		for (size_t type = 0; type < pending.size(); type++)
+			allocate(type);
+		allAllocated = true;
+	}
+
+private:
+	struct Pending {
+		size_t id;
+		EXPRESSTokenizer::token statement;
+	};
+
+	class Statement : public EXPRESSLazyAttributes {
+	public:
+		Statement(EXPRESSLazyDecoder* decoder, EXPRESSTokenizer::token statement, Reader reader)
+			: decoder(decoder), statement(statement), reader(reader) { }
+
+		virtual void decode(EXPRESSEntity& entity) const override {
+			decoder->decode(entity, *this);
+		}
+
+		EXPRESSLazyDecoder* decoder;
+		EXPRESSTokenizer::token statement;
+		Reader reader;
+	};
+
+	int32_t typeOf(size_t id) const {
+		if (!denseTypes.empty())
+			return id < denseTypes.size() ? denseTypes[id] : -1;
+		auto it = std::lower_bound(sparseTypes.begin(), sparseTypes.end(), std::make_pair(id, std::numeric_limits<int32_t>::min()));
+		return it != sparseTypes.end() && it->first == id ? it->second : -1;
+	}
+
+	/// Allocates the slab of a type and places its entities in the store, once. Other threads wait until it is placed.
+	void allocate(size_t type) {
+		std::call_once(allocated[type], [this, type]() {
+			std::vector<Pending>& entities = pending[type];
+			if (entities.empty())
+				return;
+
+			std::vector<size_t> indices(entities.size());
+			std::iota(indices.begin(), indices.end(), 0);
+			std::vector<std::shared_ptr<EXPRESSEntity>> slab(entities.size());
+			allocators[type](arena, indices, slab);
+
+			statements[type].reserve(entities.size());
+			for (size_t k = 0; k < entities.size(); k++) {
+				statements[type].push_back(Statement(this, entities[k].statement, readers[type]));
+				slab[k]->setId(entities[k].id);
+				slab[k]->setLazyAttributes(&statements[type].back());
+				store.place(entities[k].id, slab[k]);
+			}
+			std::vector<Pending>().swap(entities);
+		});
+	}
+
+	void decode(EXPRESSEntity& entity, const Statement& statement) {
+		// Entities are decoded under one of a few striped locks, a second thread waits until the attributes are complete.
+		std::lock_guard<std::mutex> lock(mutexes[std::hash<const void*>()(&entity) % mutexes.size()]);
+		if (entity.getLazyAttributes() != &statement)
+			return;
+
+		const std::shared_ptr<EXPRESSModel> owner = model.lock();
+		if (!owner)
+			throw std::runtime_error("Entity #" + std::to_string(entity.getId()) + " is decoded after its model was destroyed.");
+
+		thread_local std::vector<EXPRESSTokenizer::token> args;
+		std::vector<size_t> unresolved;
+		EXPRESSTokenizer::splitArguments(statement.statement, args);
+		statement.reader(entity, args, owner);
+		entity.linkReferences(*owner, unresolved);
+		entity.setLazyAttributes(nullptr);
+
+		if (!unresolved.empty()) {
+			std::cout << entity.getStepParameter() << ": " << unresolved.size() << " referenced entities are missing or of an unexpected type:";
+			for (const size_t id : unresolved)
+				std::cout << " #" << id;
+			std::cout << std::endl;
+		}
+	}
+
+	const std::shared_ptr<EXPRESSMappedFile> file;
+	const std::weak_ptr<EXPRESSModel> model;
+	// Only used while loading, which the store of the living model does.
+	EXPRESSArena& arena;
+	EXPRESSEntityStore& store;
+	const Allocator* const allocators;
+	const Reader* const readers;
+
+	std::vector<int32_t> denseTypes;
+	std::vector<std::pair<size_t, int32_t>> sparseTypes;
+	std::vector<std::vector<Pending>> pending;
+	std::vector<std::vector<Statement>> statements;
+	std::unique_ptr<std::once_flag[]> allocated;
+	std::atomic<bool> allAllocated{ false };
+	std::array<std::mutex, 64> mutexes;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSLazyDecoder);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSLazyDecoder_47d2e9b1_8c06_4f3a_9e5d_a1b7c3f60e28_h
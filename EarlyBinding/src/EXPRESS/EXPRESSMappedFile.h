@@ -0,0 +1,67 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSMappedFile_3f1c9d2e_5b7a_4e08_9c61_2d8e4a7b0f53_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSMappedFile_3f1c9d2e_5b7a_4e08_9c61_2d8e4a7b0f53_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include <string>
+#include <stdexcept>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/utility/string_view.hpp>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Read-only memory mapping of a STEP file. The readers tokenize directly inside the mapped pages,
+/// so the file content is never copied into intermediate strings.
+class EXPRESSMappedFile {
+public:
+	EXPRESSMappedFile(const std::string &filename) {
+		try {
+			mapping = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+			region = boost::interprocess::mapped_region(mapping, boost::interprocess::read_only);
+		}
+		catch (const boost::interprocess::interprocess_exception&) {
+			throw std::runtime_error("Could not open file " + filename + ".");
+		}
+		region.advise(boost::interprocess::mapped_region::advice_sequential);
+	}
+
+	EXPRESSMappedFile(const EXPRESSMappedFile&) = delete;
+	EXPRESSMappedFile& operator=(const EXPRESSMappedFile&) = delete;
+
+	const char* data() const { return static_cast<const char*>(region.get_address()); }
+	size_t size() const { return region.get_size(); }
+
+	boost::string_view view() const { return boost::string_view(data(), size()); }
+
+private:
+	boost::interprocess::file_mapping mapping;
+	boost::interprocess::mapped_region region;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSMappedFile);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSMappedFile_3f1c9d2e_5b7a_4e08_9c61_2d8e4a7b0f53_h
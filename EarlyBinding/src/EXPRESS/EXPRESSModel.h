@@ -24,19 +24,27 @@
 #include "../EarlyBinding/src/namespace.h"
 
 #include "EXPRESSEntity.h"
+#include "EXPRESSEntityStore.h"
+#include "EXPRESSArena.h"
+#include "EXPRESSExtents.h"
+#include "EXPRESSInverseIndex.h"
 
 #include <string>
-#include <map>
 #include <memory>
 #include <algorithm>
+#include <mutex>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
 
+class EXPRESSLazyDecoder;
+
 class EXPRESSModel {
 public:
-	EXPRESSModel(const std::string &schema) : schema(schema) { };
+	EXPRESSModel(const std::string &schema) : schema(schema), arena(std::make_shared<EXPRESSArena>()) { };
 
 	~EXPRESSModel() {
+		// Entities of a lazily read model that were never accessed are not allocated anymore.
+		entities.setLoader(nullptr);
 		if (!entities.empty()) {
 			std::for_each(entities.begin(), entities.end(), [](auto& elem) {
 				elem.second = nullptr;
@@ -51,7 +59,26 @@ public:
 	//};
 
 	const std::string schema;
-	std::map<size_t, std::shared_ptr<EXPRESSEntity>> entities;
+	const std::shared_ptr<EXPRESSArena> arena;
+	EXPRESSEntityStore entities;
+
+	/// The ids of the entities grouped by type, filled by the reader. Entities added afterwards are not part of the extents.
+	EXPRESSExtents extents;
+
+	/// Set if the model was read in lazy mode, decodes the attributes of the entities on first access.
+	std::shared_ptr<EXPRESSLazyDecoder> lazyDecoder;
+
+	/// Returns the entities referencing each entity, which the generated INVERSE attributes are answered from. The reader
+	/// builds the index after the link pass, models read in lazy mode build it on first use, which decodes all entities.
+	/// Entities added afterwards are not part of the index.
+	const EXPRESSInverseIndex& inverses() const {
+		std::call_once(inverseIndexBuilt, [this]() { inverseIndex = std::make_shared<EXPRESSInverseIndex>(entities); });
+		return *inverseIndex;
+	}
+
+private:
+	mutable std::once_flag inverseIndexBuilt;
+	mutable std::shared_ptr<const EXPRESSInverseIndex> inverseIndex;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
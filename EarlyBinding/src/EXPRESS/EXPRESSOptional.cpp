@@ -16,6 +16,10 @@
 	along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+// Guarded, unity sources include this once per generated source.
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSOptional_cpp_1108a3b9_3af4_45af_aeda_fbb9a6a8df80
+#define OpenInfraPlatform_EarlyBinding_EXPRESSOptional_cpp_1108a3b9_3af4_45af_aeda_fbb9a6a8df80
+
 #include "EXPRESSOptional.h"
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
@@ -47,7 +51,7 @@ template <typename T> const std::string EXPRESSOptional<T>::getStepParameter() c
 	}
 }
 
-template <typename T> EXPRESSOptional<T> EXPRESSOptional<T>::readStepData(const std::string& value, const std::shared_ptr<EXPRESSModel>& model) {
+template <typename T> EXPRESSOptional<T> EXPRESSOptional<T>::readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model) {
 	EXPRESSOptional opt;
 	T val;
 	if (value != "$") {
@@ -57,4 +61,6 @@ template <typename T> EXPRESSOptional<T> EXPRESSOptional<T>::readStepData(const
 	return opt;
 }
 
-OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
\ No newline at end of file
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSOptional_cpp_1108a3b9_3af4_45af_aeda_fbb9a6a8df80
\ No newline at end of file
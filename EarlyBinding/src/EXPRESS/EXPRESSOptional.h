@@ -24,6 +24,8 @@
 #include "../EarlyBinding/src/namespace.h"
 
 #include "EXPRESSModel.h"
+#include "EXPRESSSnapshot.h"
+#include "EXPRESSTokenizer.h"
 
 #include <utility>
 #include <iostream>
@@ -67,7 +69,7 @@ public:
 	//EXPRESSOptional& operator=(const T& other) { boost::optional<T>::operator=(other); return *this; };
 
 	
-	operator ForwardType &() & { return (ForwardType&) this->base::get(); }
+	operator ForwardType &() & { return static_cast<ForwardType&>(this->base::get()); }
 	//operator const ForwardType () const { return (const ForwardType) this->base::get(); }
 	
 	operator T&() & { return this->get(); }
@@ -90,7 +92,41 @@ public:
 	//	}
 	//}
 
-	static EXPRESSOptional readStepData(const std::string& value, const std::shared_ptr<EXPRESSModel>& model);
+	static EXPRESSOptional readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model);
+
+	void link(const EXPRESSModel& model, std::vector<size_t>& unresolved) {
+		if (this->is_initialized())
+			this->get().link(model, unresolved);
+	}
+
+	template <typename F> void forEachReference(const F& f) const {
+		if (this->is_initialized())
+			this->get().forEachReference(f);
+	}
+
+	void writeStepParameter(std::string& out) const {
+		if (this->is_initialized())
+			this->get().writeStepParameter(out);
+		else
+			out += '$';
+	}
+
+	/// Optional values are stored with a leading flag.
+	void writeSnapshot(EXPRESSSnapshotWriter& out) const {
+		out.write(this->is_initialized());
+		if (this->is_initialized())
+			this->get().writeSnapshot(out);
+	}
+
+	void readSnapshot(EXPRESSSnapshotReader& in) {
+		if (in.next<bool>()) {
+			this->base::emplace();
+			this->get().readSnapshot(in);
+		}
+		else {
+			this->base::reset();
+		}
+	}
 	//static EXPRESSOptional readStepData(const std::string& value, const std::shared_ptr<EXPRESSModel>& model) {
 	//	EXPRESSOptional opt;
 	//	T val;
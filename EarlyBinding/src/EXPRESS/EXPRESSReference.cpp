@@ -16,26 +16,28 @@
 	along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+// Guarded, unity sources include this once per generated source.
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSReference_cpp_6401d159_29ed_4b05_95d5_d5bdf94cd2ab
+#define OpenInfraPlatform_EarlyBinding_EXPRESSReference_cpp_6401d159_29ed_4b05_95d5_d5bdf94cd2ab
+
 #include "EXPRESSReference.h"
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
 
 template <typename T> const std::string EXPRESSReference<T>::getStepParameter() const {
-	const std::shared_ptr<T> ptr = this->base::lock();
-	return ptr.get()->getStepParameter();
-	//return this->base::lock().get()->getStepParameter();
+	return entity ? entity->getStepParameter() : "#" + std::to_string(refId);
 }
 
 template <typename T> const std::string EXPRESSReference<T>::classname() const {
-	const std::shared_ptr<T> ptr = this->base::lock();
-	// Lock on this and return runtime classname or if empty construct T and return T.classname()
-	if (ptr) {
-		return ptr.get()->classname();
+	// Return the runtime classname of the referenced entity
+	if (entity) {
+		return entity->classname();
 	}
 	else {
 		return "unknown";
 	}
-	//return this->base::lock().get()->classname();
 }
 
-OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
\ No newline at end of file
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSReference_cpp_6401d159_29ed_4b05_95d5_d5bdf94cd2ab
\ No newline at end of file
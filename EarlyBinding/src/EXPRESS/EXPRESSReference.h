@@ -25,87 +25,129 @@
 
 #include "EXPRESSEntity.h"
 #include "EXPRESSModel.h"
+#include "EXPRESSSnapshot.h"
+#include "EXPRESSStepFormat.h"
+#include "EXPRESSTokenizer.h"
 
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
 
-template <typename T> class EXPRESSReference : public std::weak_ptr<T> {
+/// Reference to an entity of the same model. The reference is a raw handle to the entity inside the model's arena
+/// together with the STEP id, so it is two words large and dereferencing it involves no reference counting.
+/// The model guarantees the lifetime of the referenced entity; lock() hands out a shared pointer which aliases the
+/// arena of the model and keeps it alive like the pointers in EXPRESSModel::entities.
+/// References are resolved once in the link pass of the reader and are only read afterwards, so threads can share them.
+template <typename T> class EXPRESSReference {
 	//static_assert(std::is_base_of<EXPRESSEntity, T>::value, "EXPRESSReference can only be specialized with class derived from EXPRESSEntity");
-	using base = std::weak_ptr<T>;
 public:
-	typedef base UnderlyingType;
+	typedef T* UnderlyingType;
+	typedef T element_type;
 
 	EXPRESSReference() = default;
 	EXPRESSReference(const EXPRESSReference& other) = default;
-	~EXPRESSReference() { 
-		this->base::reset();
-		this->model.reset();
+	EXPRESSReference(T* entity) : entity(entity), refId(entity ? entity->getId() : 0) { }
+	template <typename U> EXPRESSReference(const std::shared_ptr<U>& entity) : EXPRESSReference(entity.get()) { }
+
+	EXPRESSReference& operator=(const EXPRESSReference& other) = default;
+	EXPRESSReference& operator=(T* other) { return *this = EXPRESSReference(other); }
+	template <typename U> EXPRESSReference& operator=(const std::shared_ptr<U>& other) { return *this = EXPRESSReference(other); }
+
+	/// Entities which were not allocated in an arena, e.g. created with std::make_shared, are not owned by the pointer.
+	std::shared_ptr<T> lock() const {
+		T* object = get();
+		if (object != nullptr && object->getArena() != nullptr)
+			return object->getArena()->share(object);
+		return std::shared_ptr<T>(std::shared_ptr<T>(), object);
 	}
 
-	using base::base;
-	using base::operator=;
+	/// Returns the entity, entities of a model read in lazy mode are decoded on first access.
+	T* get() const {
+		if (entity != nullptr)
+			entity->decode();
+		return entity;
+	}
 
-	auto lock() -> decltype(this->base::lock()) {
-		if (!this->expired() && refId != 0) {
-			return this->base::lock();
-		}
-		else if (this->base::expired() && !model.expired() && refId != 0 && model.lock()->entities.count(refId) > 0) {
-			this->base::operator=(std::dynamic_pointer_cast<T>(model.lock()->entities[refId]));
-			return this->base::lock();
-		}
-		else {
-			return this->base::lock();
-		}
+	bool expired() const { return entity == nullptr; }
+
+	void reset() {
+		entity = nullptr;
+		refId = 0;
 	}
 
+	size_t getId() const { return refId; }
 
 	const std::string getStepParameter() const;
+
+	void writeStepParameter(std::string& out) const {
+		EXPRESSStepFormat::appendReference(out, refId);
+	}
 	
 
-	T* operator->() { return this->lock().operator->(); }
-	const T* const operator->() const { return this->base::lock().operator->(); }
+	T* operator->() const { return get(); }
 
-	operator const bool() const { 
-		return this->base::lock().operator bool();
+	/// The entity pointer as UnderlyingType, EXPRESSOptional forwards it by reference. The entity is decoded first.
+	explicit operator UnderlyingType&() & {
+		get();
+		return entity;
 	}
 
-	operator const bool() {
-		return this->lock().operator bool();
+	operator const bool() const { 
+		return entity != nullptr;
 	}
 
-	static EXPRESSReference<T> readStepData(const std::string arg, const std::shared_ptr<EXPRESSModel>& model) {
+	static EXPRESSReference<T> readStepData(EXPRESSTokenizer::token arg, const std::shared_ptr<EXPRESSModel>& model) {
 		if (arg == "*") {
 			//TODO
 			return EXPRESSReference<T>();
 		}
 		else {
-			size_t refId = std::stoull(arg.substr(1, arg.size() - 1));
 			EXPRESSReference<T> reference;
-			if (model->entities.count(refId) > 0) {
-				reference.base::operator=(std::dynamic_pointer_cast<T>(model->entities[refId]));
-			}
-			reference.refId = refId;
-			reference.model = model;
+			reference.refId = EXPRESSTokenizer::toId(arg);
 			return reference;
 		}
 	}
 
 	const std::string classname() const;
+
+	/// Resolves the STEP id in the link pass after all entities have been read. Ids of missing entities or entities
+	/// of an unexpected type are appended to unresolved.
+	void link(const EXPRESSModel& model, std::vector<size_t>& unresolved) {
+		if (entity == nullptr && refId != 0) {
+			entity = dynamic_cast<T*>(model.entities.get(refId).get());
+			if (entity == nullptr)
+				unresolved.push_back(refId);
+		}
+	}
+
+	template <typename F> void forEachReference(const F& f) const {
+		if (refId != 0)
+			f(refId);
+	}
+
+	/// Only the STEP id is stored, the reference is resolved by the link pass after the snapshot is read.
+	void writeSnapshot(EXPRESSSnapshotWriter& out) const {
+		out.write(static_cast<uint64_t>(refId));
+	}
+
+	void readSnapshot(EXPRESSSnapshotReader& in) {
+		entity = nullptr;
+		refId = static_cast<size_t>(in.next<uint64_t>());
+	}
 	
 
 	friend void swap(EXPRESSReference& first, EXPRESSReference& second)
 	{
-		first.base::swap(second);
+		std::swap(first.entity, second.entity);
 		std::swap(first.refId, second.refId);
-		std::swap(first.model, second.model);
 	}
 
 private:
+	T* entity = nullptr;
 	size_t refId = 0;
-	std::weak_ptr<EXPRESSModel> model;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
@@ -0,0 +1,98 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSReflection_e71b6c37_ddb1_48dc_84af_1aff4598edd4_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSReflection_e71b6c37_ddb1_48dc_84af_1aff4598edd4_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// The EXPRESS type of an attribute or, for aggregates, of its elements.
+enum class EXPRESSAttributeKind : uint8_t {
+	Simple,
+	Defined,
+	Enumeration,
+	Select,
+	Entity
+};
+
+/// Compile-time description of one attribute of a generated entity. Every generated entity class has a static constexpr
+/// function attributes() which returns a tuple with one descriptor per attribute, inherited attributes included, in
+/// the order of the STEP record.
+template <typename Entity, typename Member> struct EXPRESSAttributeDescriptor {
+	typedef Entity entity_type;
+	typedef Member member_type;
+
+	const char* name;
+	size_t index;
+	EXPRESSAttributeKind kind;
+	bool optional;
+	bool aggregate;
+	Member Entity::* member;
+
+	constexpr const Member& get(const Entity& entity) const { return entity.*member; }
+	Member& get(Entity& entity) const { return entity.*member; }
+};
+
+/// Creates the descriptor of an attribute, which may be declared by a supertype of the entity.
+template <typename Entity, typename Member, typename Owner> constexpr EXPRESSAttributeDescriptor<Entity, Member> describeAttribute(
+	const char* name, size_t index, EXPRESSAttributeKind kind, bool optional, bool aggregate, Member Owner::* member) {
+	return EXPRESSAttributeDescriptor<Entity, Member>{ name, index, kind, optional, aggregate, member };
+}
+
+/// Number of attributes of the generated entity T.
+template <typename T> constexpr size_t attributeCount() {
+	return std::tuple_size<decltype(T::attributes())>::value;
+}
+
+namespace detail {
+	template <typename Entity, typename Descriptors, typename F, size_t... I>
+	void forEachAttribute(Entity& entity, const Descriptors& descriptors, F& f, std::index_sequence<I...>) {
+		using expand = int[];
+		(void)expand{ 0, (f(std::get<I>(descriptors), std::get<I>(descriptors).get(entity)), 0)... };
+	}
+}
+
+/// Calls f(descriptor, value) for every attribute of a generated entity in the order of the STEP record. The loop is
+/// unrolled at compile time, so f is called with the exact type of every attribute and can be inlined. An entity read
+/// in lazy mode is decoded first.
+template <typename Entity, typename F> void forEachAttribute(Entity& entity, F&& f) {
+	typedef typename std::remove_const<Entity>::type Type;
+	constexpr auto descriptors = Type::attributes();
+	entity.decode();
+	detail::forEachAttribute(entity, descriptors, f, std::make_index_sequence<std::tuple_size<decltype(descriptors)>::value>());
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSAttributeKind);
+EMBED_INTO_OIP_NAMESPACE(EXPRESSAttributeDescriptor);
+EMBED_INTO_OIP_NAMESPACE(describeAttribute);
+EMBED_INTO_OIP_NAMESPACE(attributeCount);
+EMBED_INTO_OIP_NAMESPACE(forEachAttribute);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSReflection_e71b6c37_ddb1_48dc_84af_1aff4598edd4_h
@@ -0,0 +1,117 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSSnapshot_6a0d3e85_21fb_4c7e_b94d_8e5f17c2a3d6_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSSnapshot_6a0d3e85_21fb_4c7e_b94d_8e5f17c2a3d6_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/logic/tribool.hpp>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Appends values in their native binary representation, the EXPRESS types and the generated entities write their
+/// attributes with it. See EXPRESSSnapshotFile for the file layout.
+class EXPRESSSnapshotWriter {
+public:
+	template <typename T> typename std::enable_if<std::is_arithmetic<T>::value>::type write(const T& value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	template <typename T> typename std::enable_if<std::is_enum<T>::value>::type write(const T& value) {
+		write(static_cast<int32_t>(value));
+	}
+
+	void write(const std::string& value) {
+		write(static_cast<uint32_t>(value.size()));
+		buffer.insert(buffer.end(), value.begin(), value.end());
+	}
+
+	void write(const boost::logic::tribool& value) {
+		write(static_cast<char>(value.value));
+	}
+
+	const std::vector<char>& data() const { return buffer; }
+
+private:
+	std::vector<char> buffer;
+};
+
+/// Reads values written by EXPRESSSnapshotWriter from a memory range, throws if the range is exhausted.
+class EXPRESSSnapshotReader {
+public:
+	EXPRESSSnapshotReader(const char* begin, const char* end) : position(begin), end(end) { }
+
+	template <typename T> typename std::enable_if<std::is_arithmetic<T>::value>::type read(T& value) {
+		require(sizeof(T));
+		std::memcpy(&value, position, sizeof(T));
+		position += sizeof(T);
+	}
+
+	template <typename T> typename std::enable_if<std::is_enum<T>::value>::type read(T& value) {
+		value = static_cast<T>(next<int32_t>());
+	}
+
+	void read(std::string& value) {
+		const uint32_t size = next<uint32_t>();
+		require(size);
+		value.assign(position, size);
+		position += size;
+	}
+
+	void read(boost::logic::tribool& value) {
+		const char raw = next<char>();
+		if (raw < boost::logic::tribool::false_value || raw > boost::logic::tribool::indeterminate_value)
+			throw std::runtime_error("Snapshot contains an invalid LOGICAL value.");
+		value.value = static_cast<decltype(value.value)>(raw);
+	}
+
+	template <typename T> T next() {
+		T value;
+		read(value);
+		return value;
+	}
+
+	size_t remaining() const { return end - position; }
+
+private:
+	void require(size_t size) const {
+		if (size > remaining())
+			throw std::runtime_error("Snapshot is truncated.");
+	}
+
+	const char* position;
+	const char* const end;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSSnapshotWriter);
+EMBED_INTO_OIP_NAMESPACE(EXPRESSSnapshotReader);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSSnapshot_6a0d3e85_21fb_4c7e_b94d_8e5f17c2a3d6_h
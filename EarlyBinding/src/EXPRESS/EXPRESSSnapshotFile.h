@@ -0,0 +1,319 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSSnapshotFile_d4b7a1c9_3e62_4f0a_8b15_c72e9f04a6d3_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSSnapshotFile_d4b7a1c9_3e62_4f0a_8b15_c72e9f04a6d3_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+#include "EXPRESSModel.h"
+#include "EXPRESSMappedFile.h"
+#include "EXPRESSSnapshot.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sys/stat.h>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Binary snapshot of a model read from a STEP file, stored in a cache directory under a name derived from path, size
+/// and modification time of the file. Reopening the file loads the snapshot instead of parsing the STEP text as long as
+/// size, modification time and content hash of the file still match. Nothing is ever written next to the STEP file.
+///
+/// The snapshot starts with a header that names the schema and the attribute layout generated for it, followed by
+/// one section per entity type. A section holds the id and the attributes of every entity of the type in the order
+/// of the generated entity class, references are stored as the STEP ids which index the entity store of the model.
+/// Values are stored in the native byte order, the snapshot is a local cache and not meant to be exchanged.
+class EXPRESSSnapshotFile {
+public:
+	/// Format version of the encoding implemented by the EXPRESS types, changes of the generated layout are
+	/// detected by the layout hash.
+	static const uint32_t version = 2;
+
+	EXPRESSSnapshotFile(const std::string& filename, const std::string& directory, const std::string& schema, uint64_t layout)
+		: filename(filename), path(pathFor(filename, directory)), schema(schema), layout(layout) { }
+
+	const std::string& getPath() const { return path; }
+
+	/// Path of the snapshot of the file in the cache directory. A changed file gets a new name, the snapshot of the
+	/// previous version is left to the cleanup of the cache directory.
+	static std::string pathFor(const std::string& filename, const std::string& directory) {
+		Source source;
+		status(filename, source);
+		uint64_t h = 14695981039346656037ull;
+		for (const char c : filename)
+			h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		h = (h ^ source.size) * 1099511628211ull;
+		h = (h ^ static_cast<uint64_t>(source.time)) * 1099511628211ull;
+
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(h));
+		return directory + "/" + name + ".snapshot";
+	}
+
+	/// Allocates and reads the entities if the snapshot matches the file and inserts them into the model. References
+	/// are left unresolved for the link pass of the reader. Returns false if there is no valid snapshot.
+	/// allocate(type, indices, entities) constructs the entities of one type at the given indices.
+	template <typename Allocate> bool read(EXPRESSModel& model, std::vector<std::shared_ptr<EXPRESSEntity>>& entities, size_t typeCount, Allocate allocate) const {
+		std::unique_ptr<EXPRESSMappedFile> snapshot;
+		Source source;
+		if (!status(filename, source))
+			return false;
+
+		try {
+			snapshot.reset(new EXPRESSMappedFile(path));
+		}
+		catch (const std::runtime_error&) {
+			return false;
+		}
+
+		EXPRESSSnapshotReader header(snapshot->data(), snapshot->data() + snapshot->size());
+		std::vector<Section> sections;
+		uint64_t maxId = 0;
+		uint64_t entityCount = 0;
+		try {
+			char magic[signatureSize];
+			for (char& c : magic)
+				header.read(c);
+			if (std::memcmp(magic, signature(), signatureSize) != 0 || header.next<uint32_t>() != version
+				|| header.next<std::string>() != schema || header.next<uint64_t>() != layout)
+				return false;
+
+			// The content is only hashed if size and modification time match, a stale snapshot costs no extra pass.
+			if (header.next<uint64_t>() != source.size || header.next<int64_t>() != source.time)
+				return false;
+			const uint64_t hash = header.next<uint64_t>();
+			if (hash != contentHash(EXPRESSMappedFile(filename)))
+				return false;
+
+			maxId = header.next<uint64_t>();
+			const uint64_t sectionCount = header.next<uint64_t>();
+			if (sectionCount > header.remaining() / (sizeof(uint32_t) + 3 * sizeof(uint64_t)))
+				return false;
+			sections.resize(sectionCount);
+			for (Section& section : sections) {
+				header.read(section.type);
+				header.read(section.count);
+				header.read(section.offset);
+				header.read(section.size);
+				if (section.type >= typeCount || section.offset > snapshot->size() || section.size > snapshot->size() - section.offset
+					|| section.count > section.size / sizeof(uint64_t))
+					return false;
+				section.first = entityCount;
+				entityCount += section.count;
+			}
+		}
+		catch (const std::exception&) {
+			return false;
+		}
+
+		entities.assign(entityCount, nullptr);
+		bool complete = true;
+		#pragma omp parallel for schedule(dynamic)
+		for (long s = 0; s < sections.size(); s++) {
+			const Section& section = sections[s];
+			EXPRESSSnapshotReader in(snapshot->data() + section.offset, snapshot->data() + section.offset + section.size);
+			try {
+				std::vector<size_t> indices(section.count);
+				for (size_t k = 0; k < indices.size(); k++)
+					indices[k] = section.first + k;
+				allocate(section.type, indices, entities);
+
+				for (const size_t index : indices) {
+					entities[index]->setId(in.next<uint64_t>());
+					entities[index]->readSnapshot(in);
+				}
+			}
+			catch (const std::exception&) {
+				#pragma omp critical
+				complete = false;
+			}
+		}
+		if (!complete) {
+			entities.clear();
+			return false;
+		}
+
+		model.entities.reserve(maxId, entities.size());
+		#pragma omp parallel for
+		for (long i = 0; i < entities.size(); i++) {
+			model.entities.insertConcurrent(entities[i]->getId(), entities[i]);
+		}
+		model.entities.endConcurrentInsertion();
+		return true;
+	}
+
+	/// Writes the snapshot of a model read from the file. typeOf(entity) returns the type index the allocator
+	/// passed to read() expects or a negative value for entities which are not written. Returns false if the snapshot
+	/// could not be written, a partially written snapshot is never left behind.
+	template <typename TypeOf> bool write(const EXPRESSModel& model, size_t typeCount, TypeOf typeOf) const {
+		Source source;
+		if (!status(filename, source))
+			return false;
+		source.hash = contentHash(EXPRESSMappedFile(filename));
+
+		std::vector<std::vector<const EXPRESSEntity*>> entitiesByType(typeCount);
+		uint64_t maxId = 0;
+		for (const auto& entry : model.entities) {
+			const int type = entry.second ? typeOf(*entry.second) : -1;
+			if (type >= 0 && type < typeCount) {
+				entitiesByType[type].push_back(entry.second.get());
+				maxId = std::max<uint64_t>(maxId, entry.first);
+			}
+		}
+
+		std::vector<uint32_t> types;
+		for (uint32_t type = 0; type < typeCount; type++)
+			if (!entitiesByType[type].empty())
+				types.push_back(type);
+
+		std::vector<EXPRESSSnapshotWriter> bodies(types.size());
+		#pragma omp parallel for schedule(dynamic)
+		for (long s = 0; s < types.size(); s++) {
+			for (const EXPRESSEntity* entity : entitiesByType[types[s]]) {
+				bodies[s].write(static_cast<uint64_t>(entity->getId()));
+				entity->writeSnapshot(bodies[s]);
+			}
+		}
+
+		EXPRESSSnapshotWriter header;
+		for (size_t i = 0; i < signatureSize; i++)
+			header.write(signature()[i]);
+		header.write(static_cast<uint32_t>(version));
+		header.write(schema);
+		header.write(layout);
+		header.write(source.size);
+		header.write(source.time);
+		header.write(source.hash);
+		header.write(maxId);
+		header.write(static_cast<uint64_t>(types.size()));
+		// The section table has a fixed size, so the offsets of the sections are known before it is written.
+		uint64_t offset = header.data().size() + types.size() * (sizeof(uint32_t) + 3 * sizeof(uint64_t));
+		for (size_t s = 0; s < types.size(); s++) {
+			header.write(types[s]);
+			header.write(static_cast<uint64_t>(entitiesByType[types[s]].size()));
+			header.write(offset);
+			header.write(static_cast<uint64_t>(bodies[s].data().size()));
+			offset += bodies[s].data().size();
+		}
+
+		const std::string temporary = path + ".tmp";
+		{
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			out.write(header.data().data(), header.data().size());
+			for (const auto& body : bodies)
+				out.write(body.data().data(), body.data().size());
+			if (!out) {
+				out.close();
+				std::remove(temporary.c_str());
+				return false;
+			}
+		}
+		std::remove(path.c_str());
+		if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+		return true;
+	}
+
+private:
+	struct Source {
+		uint64_t size = 0;
+		int64_t time = 0;
+		uint64_t hash = 0;
+	};
+
+	struct Section {
+		uint32_t type = 0;
+		uint64_t count = 0;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint64_t first = 0;
+	};
+
+	static const size_t signatureSize = 8;
+	static const char* signature() { return "OIPSNAP"; }
+
+	static bool status(const std::string& file, Source& source) {
+#ifdef _WIN32
+		struct _stat64 info;
+		if (_stat64(file.c_str(), &info) != 0)
+			return false;
+#else
+		struct stat info;
+		if (stat(file.c_str(), &info) != 0)
+			return false;
+#endif
+		source.size = static_cast<uint64_t>(info.st_size);
+		source.time = static_cast<int64_t>(info.st_mtime);
+		return true;
+	}
+
+	/// FNV-1a over 8 byte words of independent 1 MiB chunks, the chunks are hashed in parallel and combined in order.
+	static uint64_t contentHash(const EXPRESSMappedFile& file) {
+		const uint64_t basis = 14695981039346656037ull;
+		const uint64_t prime = 1099511628211ull;
+		const size_t chunkSize = 1 << 20;
+		const long chunkCount = static_cast<long>((file.size() + chunkSize - 1) / chunkSize);
+		std::vector<uint64_t> chunks(chunkCount);
+		#pragma omp parallel for
+		for (long c = 0; c < chunkCount; c++) {
+			const char* it = file.data() + c * chunkSize;
+			const char* const end = file.data() + std::min(file.size(), (c + 1) * chunkSize);
+			uint64_t h = basis;
+			for (; end - it >= 8; it += 8) {
+				uint64_t word;
+				std::memcpy(&word, it, sizeof(word));
+				h = (h ^ word) * prime;
+				h ^= h >> 32;
+			}
+			for (; it != end; it++)
+				h = (h ^ static_cast<unsigned char>(*it)) * prime;
+			chunks[c] = h;
+		}
+
+		uint64_t h = basis ^ file.size();
+		for (const uint64_t chunk : chunks)
+			h = (h ^ chunk) * prime;
+		return h;
+	}
+
+	const std::string filename;
+	const std::string path;
+	const std::string schema;
+	const uint64_t layout;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSSnapshotFile);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSSnapshotFile_d4b7a1c9_3e62_4f0a_8b15_c72e9f04a6d3_h
@@ -0,0 +1,139 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSStepFormat_8e21c6f4_05ad_4b3e_9f72_d1a84b6e93c0_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSStepFormat_8e21c6f4_05ad_4b3e_9f72_d1a84b6e93c0_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSTokenizer.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Appends STEP parameters to a line buffer, the counterpart of EXPRESSTokenizer. Numbers are formatted in stack
+/// buffers, so writing into a buffer with enough capacity does not allocate.
+class EXPRESSStepFormat {
+public:
+	static void appendInteger(std::string& out, int64_t value) {
+		char digits[24];
+		char* it = digits + sizeof(digits);
+		uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+		do {
+			*--it = static_cast<char>('0' + magnitude % 10);
+			magnitude /= 10;
+		} while (magnitude != 0);
+		if (value < 0)
+			*--it = '-';
+		out.append(it, digits + sizeof(digits));
+	}
+
+	/// Appends the shortest of 15 to 17 significant digits that EXPRESSTokenizer::parseNumber reads back exactly.
+	/// STEP requires a decimal point in every REAL, so 1000 is written as "1000." and 1e-05 as "1.E-05".
+	static void appendReal(std::string& out, double value) {
+		if (!std::isfinite(value)) {
+			out += "0.";
+			return;
+		}
+
+		char buffer[40];
+		int length = 0;
+		for (int precision = 15; precision <= 17; precision++) {
+			length = std::snprintf(buffer, sizeof(buffer), "%.*G", precision, value);
+			// The decimal separator of printf depends on the locale, STEP always uses a point.
+			for (int i = 0; i < length; i++) {
+				if (buffer[i] == ',')
+					buffer[i] = '.';
+			}
+
+			const char* it = buffer;
+			double parsed = 0.0;
+			if (EXPRESSTokenizer::parseNumber(it, buffer + length, parsed) && parsed == value)
+				break;
+		}
+
+		int exponent = length;
+		bool point = false;
+		for (int i = 0; i < length; i++) {
+			if (buffer[i] == '.')
+				point = true;
+			else if (buffer[i] == 'E' && exponent == length)
+				exponent = i;
+		}
+
+		out.append(buffer, exponent);
+		if (!point)
+			out += '.';
+		out.append(buffer + exponent, length - exponent);
+	}
+
+	static void appendLogical(std::string& out, bool value) {
+		out += value ? ".T." : ".F.";
+	}
+
+	static void appendReference(std::string& out, size_t id) {
+		if (id == 0) {
+			out += '$';
+			return;
+		}
+		out += '#';
+		appendInteger(out, static_cast<int64_t>(id));
+	}
+
+	/// Appends a string value read by EXPRESSTokenizer::toText as STEP string literal. Only the quotes are doubled,
+	/// the backslash escapes are still encoded in the value.
+	static void appendText(std::string& out, const std::string& text) {
+		out += '\'';
+		for (const char c : text) {
+			if (c == '\'')
+				out += c;
+			out += c;
+		}
+		out += '\'';
+	}
+
+	/// Appends plain text as STEP string literal, quotes and backslashes are doubled.
+	static void appendString(std::string& out, const std::string& text) {
+		out += '\'';
+		for (const char c : text) {
+			if (c == '\'' || c == '\\')
+				out += c;
+			out += c;
+		}
+		out += '\'';
+	}
+
+	/// Appends the name of a type or entity in upper case, the spelling of keywords in STEP files.
+	static void appendKeyword(std::string& out, const std::string& name) {
+		for (const char c : name)
+			out += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+	}
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSStepFormat);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSStepFormat_8e21c6f4_05ad_4b3e_9f72_d1a84b6e93c0_h
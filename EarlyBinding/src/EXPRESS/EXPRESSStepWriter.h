@@ -0,0 +1,151 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSStepWriter_c53a8e17_4f92_4d6b_a0e4_7b19d2f86c35_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSStepWriter_c53a8e17_4f92_4d6b_a0e4_7b19d2f86c35_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSEntity.h"
+#include "EXPRESSModel.h"
+#include "EXPRESSStepFormat.h"
+
+#include <algorithm>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Writes a model as ISO 10303-21 file. The entities are formatted in rounds of chunks in parallel into buffers that
+/// are reused from round to round, while one thread writes the previous round to the file.
+class EXPRESSStepWriter {
+public:
+	static void write(const EXPRESSModel& model, const std::string& filename) {
+		std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			throw std::runtime_error("Could not open " + filename + " for writing.");
+
+		std::string header;
+		writeHeader(header, model, filename);
+		file.write(header.data(), header.size());
+
+		std::vector<const EXPRESSEntity*> entities;
+		entities.reserve(model.entities.size());
+		for (const auto& entry : model.entities) {
+			if (entry.second)
+				entities.push_back(entry.second.get());
+		}
+		// The store iterates in ascending order of the ids, so the file is written in the same order.
+
+		const long count = static_cast<long>(entities.size());
+		const long chunks = (count + chunkSize - 1) / chunkSize;
+		long round = 4;
+#ifdef _OPENMP
+		round = std::max(1L, 4L * omp_get_max_threads());
+#endif
+		std::vector<std::string> current, previous;
+		bool failed = false;
+		// Lazy entities are decoded while they are formatted, the first error is rethrown after the round.
+		std::exception_ptr error;
+
+		for (long first = 0; first < chunks; first += round) {
+			const long last = std::min(first + round, chunks);
+			current.resize(static_cast<size_t>(last - first));
+
+			#pragma omp parallel
+			{
+				#pragma omp single nowait
+				failed = !writeBuffers(file, previous) || failed;
+
+				#pragma omp for schedule(dynamic)
+				for (long chunk = first; chunk < last; chunk++) {
+					std::string& buffer = current[chunk - first];
+					buffer.clear();
+					const long end = std::min((chunk + 1) * chunkSize, count);
+					try {
+						for (long i = chunk * chunkSize; i < end; i++) {
+							entities[i]->writeStepLine(buffer);
+							buffer += ";\n";
+						}
+					}
+					catch (...) {
+						#pragma omp critical
+						if (!error)
+							error = std::current_exception();
+					}
+				}
+			}
+			if (error)
+				std::rethrow_exception(error);
+			std::swap(current, previous);
+		}
+		failed = !writeBuffers(file, previous) || failed;
+
+		file << "ENDSEC;\nEND-ISO-10303-21;\n";
+		file.close();
+		if (failed || file.fail())
+			throw std::runtime_error("Could not write " + filename + ".");
+	}
+
+private:
+	static const long chunkSize = 4096;
+
+	static void writeHeader(std::string& out, const EXPRESSModel& model, const std::string& filename) {
+		const size_t separator = filename.find_last_of("/\\");
+		const std::string name = separator == std::string::npos ? filename : filename.substr(separator + 1);
+
+		char timestamp[32] = "";
+		const std::time_t now = std::time(nullptr);
+		std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+		out += "ISO-10303-21;\nHEADER;\nFILE_DESCRIPTION((''),'2;1');\n";
+		out += "FILE_NAME(";
+		EXPRESSStepFormat::appendString(out, name);
+		out += ",'";
+		out += timestamp;
+		out += "',(''),(''),'','OpenInfraPlatform','');\n";
+		out += "FILE_SCHEMA(('";
+		EXPRESSStepFormat::appendKeyword(out, model.schema);
+		out += "'));\nENDSEC;\nDATA;\n";
+	}
+
+	static bool writeBuffers(std::ofstream& file, std::vector<std::string>& buffers) {
+		for (std::string& buffer : buffers) {
+			file.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+		return !file.fail();
+	}
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSStepWriter);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSStepWriter_c53a8e17_4f92_4d6b_a0e4_7b19d2f86c35_h
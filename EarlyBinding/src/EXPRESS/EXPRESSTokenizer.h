@@ -0,0 +1,615 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSTokenizer_a84e1f07_2c3d_4b9e_b5f6_7d0c19e3a2b8_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSTokenizer_a84e1f07_2c3d_4b9e_b5f6_7d0c19e3a2b8_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <boost/utility/string_view.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Tokenizes STEP physical files in place. All tokens are spans into the original buffer,
+/// a copy into a std::string is only made where an attribute value is finally interpreted.
+class EXPRESSTokenizer {
+public:
+	typedef boost::string_view token;
+
+	static bool isWhitespace(const char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+	}
+
+	static token trim(token value) {
+		while (!value.empty() && isWhitespace(value.front()))
+			value.remove_prefix(1);
+		while (!value.empty() && isWhitespace(value.back()))
+			value.remove_suffix(1);
+		return value;
+	}
+
+	/// Parses the decimal entity instance name of "#123" or "123". Returns false if it is malformed.
+	static bool tryToId(token value, size_t &id) {
+		value = trim(value);
+		if (!value.empty() && value.front() == '#')
+			value.remove_prefix(1);
+		if (value.empty())
+			return false;
+		id = 0;
+		for (const char c : value) {
+			if (c < '0' || c > '9')
+				return false;
+			id = id * 10 + (c - '0');
+		}
+		return true;
+	}
+
+	static size_t toId(token value) {
+		size_t id = 0;
+		if (!tryToId(value, id))
+			throw std::invalid_argument("Invalid entity instance name.");
+		return id;
+	}
+
+	/// Parses a STEP REAL or INTEGER like "-12", "0." or "1.5E-3" at it and advances it behind the number.
+	/// The parser does not depend on the locale. Numbers with up to 15 significant digits and a small exponent are
+	/// converted exactly from the integer mantissa without allocating, all others fall back to a classic stream.
+	static bool parseNumber(const char* &it, const char* end, double &result) {
+		static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+		const char* begin = it;
+		const char* p = it;
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+
+		uint64_t mantissa = 0;
+		int digits = 0, exponent = 0;
+		bool hasDigits = false;
+		for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+			hasDigits = true;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0 ? 1 : 0;
+			}
+			else {
+				exponent++;
+			}
+		}
+		if (p < end && *p == '.') {
+			for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+				hasDigits = true;
+				if (digits < 19) {
+					mantissa = mantissa * 10 + (*p - '0');
+					digits += mantissa != 0 ? 1 : 0;
+					exponent--;
+				}
+			}
+		}
+		if (!hasDigits)
+			return false;
+		if (p < end && (*p == 'E' || *p == 'e')) {
+			const char* q = p + 1;
+			bool negativeExponent = false;
+			if (q < end && (*q == '-' || *q == '+'))
+				negativeExponent = *q++ == '-';
+			if (q < end && *q >= '0' && *q <= '9') {
+				int value = 0;
+				for (; q < end && *q >= '0' && *q <= '9'; ++q)
+					value = value < 10000 ? value * 10 + (*q - '0') : value;
+				exponent += negativeExponent ? -value : value;
+				p = q;
+			}
+		}
+		it = p;
+
+		if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+			const double value = static_cast<double>(mantissa);
+			result = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+		}
+		else {
+			// The stream has to read exactly the scanned number, otherwise the value cannot be represented
+			std::istringstream stream(std::string(begin, p));
+			stream.imbue(std::locale::classic());
+			stream >> result;
+			return !stream.fail() && stream.peek() == std::char_traits<char>::eof();
+		}
+		if (negative)
+			result = -result;
+		return true;
+	}
+
+	static double toReal(token value) {
+		value = trim(value);
+		const char* it = value.data();
+		double result = 0.0;
+		if (!parseNumber(it, value.data() + value.size(), result) || it != value.data() + value.size())
+			throw std::invalid_argument("Invalid number " + std::string(value.data(), value.size()) + ".");
+		return result;
+	}
+
+	static int toInteger(token value) {
+		value = trim(value);
+		const char* it = value.data();
+		const char* end = value.data() + value.size();
+		bool negative = false;
+		if (it < end && (*it == '-' || *it == '+'))
+			negative = *it++ == '-';
+		if (it == end || *it < '0' || *it > '9')
+			throw std::invalid_argument("Invalid number " + std::string(value.data(), value.size()) + ".");
+		long long result = 0;
+		for (; it < end && *it >= '0' && *it <= '9'; ++it) {
+			result = result * 10 + (*it - '0');
+			if (result > static_cast<long long>(std::numeric_limits<int>::max()) + 1)
+				throw std::out_of_range("Number " + std::string(value.data(), value.size()) + " is out of range.");
+		}
+		if (it != end)
+			throw std::invalid_argument("Invalid number " + std::string(value.data(), value.size()) + ".");
+		if (!negative && result > std::numeric_limits<int>::max())
+			throw std::out_of_range("Number " + std::string(value.data(), value.size()) + " is out of range.");
+		return static_cast<int>(negative ? -result : result);
+	}
+
+	/// Returns the text of a string literal without the enclosing quotes, a doubled quote '' becomes one quote. The
+	/// backslash escapes (\\, \S\, \X\, \X2\ ... \X0\) stay encoded and are written back by EXPRESSStepFormat::appendText.
+	static std::string toText(token value) {
+		value = trim(value);
+		if (value.size() < 2 || value.front() != '\'' || value.back() != '\'')
+			return std::string(value.data(), value.size());
+		const char* const end = value.data() + value.size() - 1;
+		std::string result;
+		result.reserve(value.size() - 2);
+		for (const char* it = value.data() + 1; it < end; ++it) {
+			result.push_back(*it);
+			if (*it == '\'' && it + 1 < end && it[1] == '\'')
+				++it;
+		}
+		return result;
+	}
+
+	/// Bulk path for lists of lists of numbers like the coordinates of IfcCartesianPointList3D. All numbers are parsed
+	/// into one contiguous buffer, lengths receives the size of every inner list. Returns false if the value is not
+	/// such a list, e.g. because it contains unset values, and the caller has to use the generic path.
+	static bool readNumberLists(token value, std::vector<double> &numbers, std::vector<size_t> &lengths) {
+		numbers.clear();
+		lengths.clear();
+		const char* it = skipWhitespace(value.data(), value.data() + value.size());
+		const char* end = value.data() + value.size();
+		if (it == end || *it != '(')
+			return false;
+		it = skipWhitespace(it + 1, end);
+		if (it < end && *it == ')')
+			return true;
+
+		while (it < end) {
+			if (*it != '(')
+				return false;
+			const size_t first = numbers.size();
+			it = skipWhitespace(it + 1, end);
+			if (it < end && *it == ')') {
+				it = skipWhitespace(it + 1, end);
+			}
+			else {
+				while (true) {
+					double number = 0.0;
+					if (!parseNumber(it, end, number))
+						return false;
+					numbers.push_back(number);
+					it = skipWhitespace(it, end);
+					if (it == end)
+						return false;
+					if (*it == ')') {
+						it = skipWhitespace(it + 1, end);
+						break;
+					}
+					if (*it != ',')
+						return false;
+					it = skipWhitespace(it + 1, end);
+				}
+			}
+			lengths.push_back(numbers.size() - first);
+
+			if (it == end)
+				return false;
+			if (*it == ')')
+				return true;
+			if (*it != ',')
+				return false;
+			it = skipWhitespace(it + 1, end);
+		}
+		return false;
+	}
+
+	static bool isCommentStart(const char* it, const char* end) {
+		return *it == '/' && it + 1 < end && (it[1] == '*' || it[1] == '/');
+	}
+
+	/// Skips whitespace and comments. Besides the standard /* */ comments, // comments up to the end of the line are accepted.
+	static const char* skipWhitespace(const char* it, const char* end) {
+		while (it < end) {
+			if (isWhitespace(*it)) {
+				++it;
+			}
+			else if (isCommentStart(it, end) && it[1] == '*') {
+				const char* close = it + 2;
+				while (close + 1 < end && !(close[0] == '*' && close[1] == '/'))
+					++close;
+				it = close + 1 < end ? close + 2 : end;
+			}
+			else if (isCommentStart(it, end)) {
+				it = std::find(it + 2, end, '\n');
+			}
+			else {
+				break;
+			}
+		}
+		return it;
+	}
+
+	/// Skips the string literal beginning at the quote it points to. A doubled quote '' is an escaped quote,
+	/// all other escapes (\\, \S\, \X\, \X2\ ... \X0\) cannot contain a quote and are left to the value.
+	static const char* skipString(const char* it, const char* end) {
+		for (++it; it < end; ++it) {
+			if (*it == '\'') {
+				if (it + 1 < end && it[1] == '\'')
+					++it;
+				else
+					return it + 1;
+			}
+		}
+		return end;
+	}
+
+	/// Calls the function for every element of the list beginning at the parenthesis it points to and returns the
+	/// position behind the closing parenthesis. Nested lists, string literals and comments are skipped in one pass,
+	/// whitespace and comments around the elements are not part of the tokens.
+	template <typename Function> static const char* forEachElement(const char* it, const char* end, Function function) {
+		size_t depth = 0;
+		size_t count = 0;
+		const char* begin = skipWhitespace(it + 1, end);
+		const char* last = begin;
+		it = begin;
+		while (it < end) {
+			const char c = *it;
+			if (c == '\'') {
+				it = last = skipString(it, end);
+				continue;
+			}
+			if (isCommentStart(it, end)) {
+				it = skipWhitespace(it, end);
+				continue;
+			}
+			if (c == '(') {
+				depth++;
+			}
+			else if (c == ')') {
+				if (depth == 0) {
+					if (last != begin || count > 0)
+						function(token(begin, last - begin));
+					return it + 1;
+				}
+				depth--;
+			}
+			else if (c == ',' && depth == 0) {
+				function(token(begin, last - begin));
+				count++;
+				it = begin = last = skipWhitespace(it + 1, end);
+				continue;
+			}
+			if (!isWhitespace(c))
+				last = it + 1;
+			++it;
+		}
+		return end;
+	}
+
+	/// Splits an entity instance "#id=TYPE(parameters)" into its parts.
+	/// The parameter span begins at the opening parenthesis. Returns false if the statement is no simple entity instance.
+	static bool splitInstance(token statement, size_t &id, token &type, token &parameters) {
+		const char* const end = statement.data() + statement.size();
+		const char* it = skipWhitespace(statement.data(), end);
+		if (it == end || *it != '#')
+			return false;
+
+		const char* name = it++;
+		while (it < end && *it >= '0' && *it <= '9')
+			++it;
+		if (!tryToId(token(name, it - name), id))
+			return false;
+
+		it = skipWhitespace(it, end);
+		if (it == end || *it != '=')
+			return false;
+
+		it = skipWhitespace(it + 1, end);
+		const char* keyword = it;
+		while (it < end && (std::isalnum(static_cast<unsigned char>(*it)) || *it == '_' || *it == '!'))
+			++it;
+		type = token(keyword, it - keyword);
+
+		it = skipWhitespace(it, end);
+		if (type.empty() || it == end || *it != '(')
+			return false;
+
+		parameters = trim(token(it, end - it));
+		return true;
+	}
+
+	/// Splits an entity instance into its name and its top-level parameters,
+	/// i.e. "#7=IFCCARTESIANPOINT((0.,1.),$)" yields "#7", "(0.,1.)" and "$".
+	/// The arguments are written into the given vector, which keeps its capacity between calls.
+	static void splitArguments(token statement, std::vector<token> &args) {
+		args.clear();
+		size_t id = 0;
+		token type, parameters;
+		if (splitInstance(statement, id, type, parameters)) {
+			const char* name = skipWhitespace(statement.data(), type.data());
+			const char* nameEnd = name + 1;
+			while (*nameEnd >= '0' && *nameEnd <= '9')
+				++nameEnd;
+			args.push_back(token(name, nameEnd - name));
+			forEachElement(parameters.data(), parameters.data() + parameters.size(), [&args](token arg) { args.push_back(arg); });
+		}
+	}
+
+	static std::vector<token> splitArguments(token statement) {
+		std::vector<token> args;
+		splitArguments(statement, args);
+		return args;
+	}
+
+	/// Copies a token into a string and drops all whitespace and comments outside of string literals.
+	static std::string toString(token value) {
+		value = trim(value);
+		const char* it = value.data();
+		const char* const end = value.data() + value.size();
+		std::string result;
+		result.reserve(value.size());
+		while (it < end) {
+			if (*it == '\'') {
+				const char* close = skipString(it, end);
+				result.append(it, close);
+				it = close;
+			}
+			else if (isCommentStart(it, end)) {
+				it = skipWhitespace(it, end);
+			}
+			else {
+				if (!isWhitespace(*it))
+					result.push_back(*it);
+				++it;
+			}
+		}
+		return result;
+	}
+
+	/// An entity instance found by the index pass. The statement spans "#id=TYPE(...)" without the terminating ';'.
+	struct Instance {
+		size_t id;
+		token type;
+		token statement;
+	};
+
+	/// Lexer state between two characters. A transition only depends on the current state and character,
+	/// which allows to scan a chunk of the file once for every possible state it might begin in.
+	enum eState : unsigned char { Code = 0, Slash, String, Comment, CommentStar, LineComment, StateCount };
+
+	static eState advance(const eState state, const char c) {
+		switch (state) {
+		case String: return c == '\'' ? Code : String;
+		case Comment: return c == '*' ? CommentStar : Comment;
+		case CommentStar: return c == '/' ? Code : (c == '*' ? CommentStar : Comment);
+		case LineComment: return c == '\n' ? Code : LineComment;
+		case Slash:
+			if (c == '*') return Comment;
+			if (c == '/') return LineComment;
+			// the slash was an ordinary character
+			return c == '\'' ? String : Code;
+		default:
+			return c == '\'' ? String : (c == '/' ? Slash : Code);
+		}
+	}
+
+	/// Indexes all entity instances of the buffer. The buffer is split into one chunk per thread, 
+	/// the chunks are moved to statement boundaries (';' outside of string literals and comments)
+	/// and scanned in parallel into per-chunk tables, which are concatenated in file order.
+	static std::vector<Instance> index(token buffer) {
+		const char* const bufferBegin = buffer.data();
+		const char* const bufferEnd = buffer.data() + buffer.size();
+
+		long chunkCount = 1;
+#ifdef _OPENMP
+		chunkCount = std::max(1L, std::min(static_cast<long>(omp_get_max_threads()), static_cast<long>(buffer.size() / minimumChunkSize)));
+#endif
+		std::vector<const char*> bounds(chunkCount + 1);
+		for (long i = 0; i <= chunkCount; i++)
+			bounds[i] = bufferBegin + buffer.size() * i / chunkCount;
+
+		// Run the lexer over every chunk for all possible entry states, then chain the results to get the actual entry states.
+		std::vector<std::array<eState, StateCount>> transfers(chunkCount);
+		#pragma omp parallel for
+		for (long i = 0; i < chunkCount - 1; i++)
+			transfers[i] = transfer(bounds[i], bounds[i + 1]);
+
+		std::vector<eState> states(chunkCount, Code);
+		for (long i = 1; i < chunkCount; i++)
+			states[i] = transfers[i - 1][states[i - 1]];
+
+		std::vector<std::vector<Instance>> tables(chunkCount);
+		#pragma omp parallel for
+		for (long i = 0; i < chunkCount; i++)
+			scanChunk(bounds[i], bounds[i + 1], bufferEnd, states[i], i > 0, tables[i]);
+
+		size_t count = 0;
+		for (const auto& table : tables)
+			count += table.size();
+
+		std::vector<Instance> instances;
+		instances.reserve(count);
+		for (const auto& table : tables)
+			instances.insert(instances.end(), table.begin(), table.end());
+		return instances;
+	}
+
+	/// Calls the function with the id of every entity instance name "#123" in the parameters of the statement.
+	template <typename Function> static void forEachReference(token statement, Function function) {
+		const char* it = std::find(statement.data(), statement.data() + statement.size(), '(');
+		const char* const end = statement.data() + statement.size();
+		while (it < end) {
+			if (*it == '\'') {
+				it = skipString(it, end);
+			}
+			else if (isCommentStart(it, end)) {
+				it = skipWhitespace(it, end);
+			}
+			else if (*it == '#' && it + 1 < end && it[1] >= '0' && it[1] <= '9') {
+				size_t id = 0;
+				for (++it; it < end && *it >= '0' && *it <= '9'; ++it)
+					id = id * 10 + (*it - '0');
+				function(id);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+	/// Extends the selected instances by the instances which directly reference one of them, if accept(referring,
+	/// referenced) holds for the positions of both instances. Only references to the instances selected before count.
+	template <typename Accept> static void selectReferring(const std::vector<Instance> &instances, std::vector<char> &selected, Accept accept) {
+		std::vector<std::pair<size_t, size_t>> referenced;
+		for (size_t i = 0; i < instances.size(); i++)
+			if (selected[i])
+				referenced.push_back(std::make_pair(instances[i].id, i));
+		if (referenced.empty())
+			return;
+		std::sort(referenced.begin(), referenced.end());
+
+		std::vector<char> referring(instances.size());
+		#pragma omp parallel for schedule(dynamic, 4096)
+		for (long i = 0; i < instances.size(); i++) {
+			if (selected[i])
+				continue;
+			forEachReference(instances[i].statement, [&](size_t id) {
+				auto position = std::lower_bound(referenced.begin(), referenced.end(), std::make_pair(id, size_t(0)));
+				if (position != referenced.end() && position->first == id && accept(static_cast<size_t>(i), position->second))
+					referring[i] = true;
+			});
+		}
+		for (size_t i = 0; i < instances.size(); i++)
+			if (referring[i])
+				selected[i] = true;
+	}
+
+	/// Extends the selected instances by all instances they reference directly or indirectly.
+	static void selectReferenced(const std::vector<Instance> &instances, std::vector<char> &selected) {
+		std::unordered_map<size_t, size_t> positions;
+		positions.reserve(instances.size());
+		for (size_t i = 0; i < instances.size(); i++)
+			positions.emplace(instances[i].id, i);
+
+		std::vector<size_t> pending;
+		for (size_t i = 0; i < instances.size(); i++)
+			if (selected[i])
+				pending.push_back(i);
+
+		while (!pending.empty()) {
+			const size_t i = pending.back();
+			pending.pop_back();
+			forEachReference(instances[i].statement, [&](size_t id) {
+				auto position = positions.find(id);
+				if (position != positions.end() && !selected[position->second]) {
+					selected[position->second] = true;
+					pending.push_back(position->second);
+				}
+			});
+		}
+	}
+
+private:
+	static const size_t minimumChunkSize = 1 << 20;
+
+	static std::array<eState, StateCount> transfer(const char* begin, const char* end) {
+		std::array<eState, StateCount> states;
+		for (unsigned char s = 0; s < StateCount; s++)
+			states[s] = static_cast<eState>(s);
+		for (const char* it = begin; it < end; ++it) {
+			for (auto& state : states)
+				state = advance(state, *it);
+		}
+		return states;
+	}
+
+	/// Scans the statements of one chunk. Except for the first chunk, the statement that overlaps the beginning
+	/// belongs to the previous chunk and is skipped. The statement that overlaps the end is completed.
+	static void scanChunk(const char* begin, const char* end, const char* bufferEnd, eState state, bool skipFirst, std::vector<Instance> &instances) {
+		const char* statement = nullptr;
+		for (const char* it = begin; it < bufferEnd; ++it) {
+			const char c = *it;
+			if (state == Code || state == Slash) {
+				if (c == ';') {
+					if (statement != nullptr && !skipFirst)
+						addInstance(token(statement, it - statement), instances);
+					statement = nullptr;
+					skipFirst = false;
+					if (it >= end)
+						return;
+				}
+				else if (statement == nullptr && !isWhitespace(c) && c != '/' && !(state == Slash && c == '*')) {
+					statement = it;
+				}
+			}
+			state = advance(state, c);
+		}
+	}
+
+	static void addInstance(token statement, std::vector<Instance> &instances) {
+		Instance instance;
+		token parameters;
+		if (splitInstance(statement, instance.id, instance.type, parameters)) {
+			instance.statement = trim(statement);
+			instances.push_back(instance);
+		}
+	}
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSTokenizer);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSTokenizer_a84e1f07_2c3d_4b9e_b5f6_7d0c19e3a2b8_h
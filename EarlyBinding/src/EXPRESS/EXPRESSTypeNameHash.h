@@ -0,0 +1,48 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSTypeNameHash_9d4c1a7e_52b3_4f08_a6e1_0b8f3d27c5a9_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSTypeNameHash_9d4c1a7e_52b3_4f08_a6e1_0b8f3d27c5a9_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include <cstdint>
+
+#include <boost/utility/string_view.hpp>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Seeded FNV-1a with a final mix. The ExpressBindingGenerator builds the tables of EXPRESSTypeTable with it, so both
+/// include this header instead of keeping copies which could silently diverge. It is not embedded into oip, the
+/// generator has its own EMBED_INTO_OIP_NAMESPACE.
+inline uint32_t hashTypeName(boost::string_view name, uint32_t seed) {
+	uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+	for (const char c : name) {
+		h ^= static_cast<unsigned char>(c);
+		h *= 16777619u;
+	}
+	h ^= h >> 15;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	return h;
+}
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSTypeNameHash_9d4c1a7e_52b3_4f08_a6e1_0b8f3d27c5a9_h
@@ -0,0 +1,62 @@
+/*
+    This file is part of Expresso, a simple early binding generator for EXPRESS.
+	Copyright (c) 2016 Technical University of Munich
+	Chair of Computational Modeling and Simulation.
+
+    BlueFramework is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    BlueFramework is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+#ifndef OpenInfraPlatform_EarlyBinding_EXPRESSTypeTable_6e2b8d41_0f9c_4a37_8b15_c3d7e9a06f24_h
+#define OpenInfraPlatform_EarlyBinding_EXPRESSTypeTable_6e2b8d41_0f9c_4a37_8b15_c3d7e9a06f24_h
+
+#include "../EarlyBinding/src/namespace.h"
+
+#include "EXPRESSTypeNameHash.h"
+
+#include <cstdint>
+#include <cstddef>
+
+#include <boost/utility/string_view.hpp>
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
+
+/// Perfect hash from upper-case STEP type names to a dense type index.
+/// The ExpressBindingGenerator computes the displacement and slot tables of a schema ("hash, displace and compress"),
+/// so a lookup costs two hashes and a single string compare.
+class EXPRESSTypeTable {
+public:
+	EXPRESSTypeTable(const char* const* names, const uint32_t* displacements, size_t bucketCount, const int* slots, size_t slotCount)
+		: names(names), displacements(displacements), bucketCount(bucketCount), slots(slots), slotMask(slotCount - 1) { }
+
+	/// Returns the index of the type name or -1 if the name is unknown.
+	int find(boost::string_view name) const {
+		const uint32_t displacement = displacements[hashTypeName(name, 0) % bucketCount];
+		const int index = slots[hashTypeName(name, displacement) & slotMask];
+		return (index >= 0 && name == names[index]) ? index : -1;
+	}
+
+private:
+	const char* const* names;
+	const uint32_t* displacements;
+	const size_t bucketCount;
+	const int* slots;
+	const size_t slotMask;
+};
+
+OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
+
+EMBED_INTO_OIP_NAMESPACE(EXPRESSTypeTable);
+
+#endif // end define OpenInfraPlatform_EarlyBinding_EXPRESSTypeTable_6e2b8d41_0f9c_4a37_8b15_c3d7e9a06f24_h
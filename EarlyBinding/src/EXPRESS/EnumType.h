@@ -43,7 +43,7 @@ public:
 
 	virtual const std::string getStepParameter() const override { return to_string(ValueType<Enum>::m_value); };
 
-	static Enum readStepData(const std::string &arg, const std::shared_ptr<EXPRESSModel>&) {
+	static Enum readStepData(EXPRESSTokenizer::token arg, const std::shared_ptr<EXPRESSModel>&) {
 		for (int i = 0; i < Count; i++) {
 			Enum value = static_cast<Enum>(i);
 			if (arg == to_string(value)) {
@@ -25,18 +25,28 @@
 
 #include "ValueType.h"
 #include "EXPRESSModel.h"
+#include "EXPRESSTokenizer.h"
 //#include "EXPRESSEntity.h"
 
 #include <type_traits>
 
 #include <boost/variant.hpp>
 #include <boost/preprocessor.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include <tuple>
 #include <utility>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_BEGIN
 
+template <typename T> class EXPRESSReference;
+
+/// Values of defined types are written with their type name, e.g. IFCLABEL('Wall'). References and values of
+/// nested select types are written as they are.
+template <typename T, typename = void> struct isTypedSelectValue : std::true_type { };
+template <typename T> struct isTypedSelectValue<EXPRESSReference<T>> : std::false_type { };
+template <typename T> struct isTypedSelectValue<T, typename std::enable_if<!std::is_void<typename T::Select>::value>::type> : std::false_type { };
+
 
 class visitor_getStepParameter
 	: public boost::static_visitor<std::string>
@@ -49,6 +59,86 @@ public:
 	}
 };
 
+class visitor_link
+	: public boost::static_visitor<void>
+{
+public:
+	visitor_link(const EXPRESSModel& model, std::vector<size_t>& unresolved) : model(model), unresolved(unresolved) { }
+
+	template <typename T>
+	void operator()(T& operand) const
+	{
+		operand.link(model, unresolved);
+	}
+
+private:
+	const EXPRESSModel& model;
+	std::vector<size_t>& unresolved;
+};
+
+class visitor_writeStepParameter
+	: public boost::static_visitor<void>
+{
+public:
+	visitor_writeStepParameter(std::string& out) : out(out) { }
+
+	template <typename T>
+	void operator()(const T& operand) const
+	{
+		write(operand, isTypedSelectValue<T>());
+	}
+
+private:
+	template <typename T>
+	void write(const T& operand, std::true_type) const
+	{
+		EXPRESSStepFormat::appendKeyword(out, operand.classname());
+		out += '(';
+		operand.writeStepParameter(out);
+		out += ')';
+	}
+
+	template <typename T>
+	void write(const T& operand, std::false_type) const
+	{
+		operand.writeStepParameter(out);
+	}
+
+	std::string& out;
+};
+
+template <typename F> class visitor_forEachReference
+	: public boost::static_visitor<void>
+{
+public:
+	visitor_forEachReference(const F& f) : f(f) { }
+
+	template <typename T>
+	void operator()(const T& operand) const
+	{
+		operand.forEachReference(f);
+	}
+
+private:
+	const F& f;
+};
+
+class visitor_writeSnapshot
+	: public boost::static_visitor<void>
+{
+public:
+	visitor_writeSnapshot(EXPRESSSnapshotWriter& out) : out(out) { }
+
+	template <typename T>
+	void operator()(const T& operand) const
+	{
+		operand.writeSnapshot(out);
+	}
+
+private:
+	EXPRESSSnapshotWriter& out;
+};
+
 template <typename ...Args> class SelectType : public ValueType<boost::variant<Args...>> {
 	using base = ValueType<boost::variant<Args...>>;
 
@@ -96,16 +186,38 @@ public:
 		return boost::apply_visitor(visitor_getStepParameter(), base::m_value);
 	}
 
-	static Select readStepData(const std::string value, const std::shared_ptr<EXPRESSModel>& model) {
+	void writeStepParameter(std::string& out) const {
+		boost::apply_visitor(visitor_writeStepParameter(out), base::m_value);
+	}
+
+	void link(const EXPRESSModel& model, std::vector<size_t>& unresolved) {
+		boost::apply_visitor(visitor_link(model, unresolved), base::m_value);
+	}
+
+	template <typename F> void forEachReference(const F& f) const {
+		boost::apply_visitor(visitor_forEachReference<F>(f), base::m_value);
+	}
+
+	/// The index of the alternative is stored ahead of its value.
+	void writeSnapshot(EXPRESSSnapshotWriter& out) const {
+		out.write(static_cast<uint32_t>(base::m_value.which()));
+		boost::apply_visitor(visitor_writeSnapshot(out), base::m_value);
+	}
+
+	void readSnapshot(EXPRESSSnapshotReader& in) {
+		readAlternative<0>(in.next<uint32_t>(), in);
+	}
+
+	static Select readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model) {
 		Select select;
 		std::tuple<Args...> variadicArgs = std::tuple<Args...>();
 		if (value == "*") {
 			//TODO
 		} else {
 			if (value[0] == '#') {
-				size_t refId = std::stoull(value.substr(1, value.size() - 1));
+				size_t refId = EXPRESSTokenizer::toId(value);
 				if (model->entities.count(refId) > 0) {
-					auto refEntity = model->entities[refId];
+					auto refEntity = model->entities.get(refId);
 					//TODO
 					SelectType::for_each(variadicArgs, [&select, &refEntity, &value, &model](auto type) {
 						typedef typename std::conditional<std::is_base_of<EXPRESSType, decltype(type)>::value, EXPRESSEntity, typename decltype(type)::element_type>::type CastType;
@@ -121,12 +233,15 @@ public:
 				}
 			}
 			else {
-				auto name = value.substr(0, value.find_first_of('('));
-				auto startpos = value.find_first_of('(') + 1;
-				auto arg = value.substr(startpos, value.find_last_of(')') - startpos);
+				// A typed value like IFCLABEL('text'), the argument is split like a list element to drop whitespace and comments
+				auto startpos = value.find_first_of('(');
+				auto name = EXPRESSTokenizer::trim(value.substr(0, startpos));
+				EXPRESSTokenizer::token arg;
+				if (startpos != EXPRESSTokenizer::token::npos)
+					EXPRESSTokenizer::forEachElement(value.data() + startpos, value.data() + value.size(), [&arg](EXPRESSTokenizer::token element) { arg = element; });
 
 				SelectType::for_each(variadicArgs, [&select, &name, &arg, &model](auto type) {
-					if (std::is_base_of<EXPRESSType, decltype(type)>::value && name == type.classname()) {
+					if (std::is_base_of<EXPRESSType, decltype(type)>::value && boost::algorithm::iequals(name, type.classname())) {
 						type = decltype(type)::readStepData(arg, model);
 						select = type;
 					}
@@ -135,6 +250,21 @@ public:
 		}
 		return select;
 	}
+
+private:
+	template <size_t I> typename std::enable_if<I == sizeof...(Args)>::type readAlternative(uint32_t, EXPRESSSnapshotReader&) {
+		throw std::runtime_error("Snapshot contains an invalid SELECT alternative.");
+	}
+
+	template <size_t I> typename std::enable_if<I < sizeof...(Args)>::type readAlternative(uint32_t which, EXPRESSSnapshotReader& in) {
+		if (which != I) {
+			readAlternative<I + 1>(which, in);
+			return;
+		}
+		std::tuple_element_t<I, std::tuple<Args...>> value;
+		value.readSnapshot(in);
+		base::m_value = value;
+	}
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EARLYBINDING_END
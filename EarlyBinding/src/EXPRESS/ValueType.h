@@ -26,6 +26,9 @@
 #include "EXPRESSOptional.h"
 #include "EXPRESSContainer.h"
 #include "EXPRESSType.h"
+#include "EXPRESSSnapshot.h"
+#include "EXPRESSStepFormat.h"
+#include "EXPRESSTokenizer.h"
 
 #include <string>
 #include <utility>
@@ -55,7 +58,11 @@ public:
 
 	virtual const std::string getStepParameter() const override { return "unknown"; };
 
-	static T readStepData(const std::string &value, const std::shared_ptr<EXPRESSModel>& model = nullptr) {
+	/// Appends the value to a STEP line, see EXPRESSStepFormat.
+	void writeStepParameter(std::string& out) const { out += this->getStepParameter(); }
+
+	/// Reads the value from its token in the STEP file, the token is not copied unless the value is a string.
+	static T readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>& model = nullptr) {
 		if (value == "*") {
 			//TODO : Implement behaviour
 			return T();
@@ -67,6 +74,15 @@ public:
 
 	virtual const std::string classname() const override { return typeid(T).name(); };
 
+	/// Values contain no references, see EXPRESSReference::link.
+	void link(const EXPRESSModel& model, std::vector<size_t>& unresolved) { }
+
+	/// Calls f with the STEP id of every referenced entity, see EXPRESSInverseIndex.
+	template <typename F> void forEachReference(const F& f) const { }
+
+	void writeSnapshot(EXPRESSSnapshotWriter& out) const { out.write(m_value); }
+	void readSnapshot(EXPRESSSnapshotReader& in) { in.read(m_value); }
+
 	virtual ValueType& operator=(const T& other) { m_value = other; return *this; }
 	virtual ValueType& operator=(const ValueType& other) { m_value = other.m_value; return *this; };
 	//virtual ValueType& operator=(const Optional<ValueType>& optional) { m_value = optional.get_value_or(T()); return *this; }
@@ -103,7 +119,7 @@ template <typename T, typename V> const bool operator==(const ValueType<T>& lhs,
 const std::string ValueType<double>::getStepParameter() const { return std::to_string(ValueType<double>::m_value); };
 const std::string ValueType<int>::getStepParameter() const { return std::to_string(ValueType<int>::m_value); };
 const std::string ValueType<bool>::getStepParameter() const { return std::to_string(ValueType<bool>::m_value); };
-const std::string ValueType<std::string>::getStepParameter() const { return "'" + ValueType<std::string>::m_value + "'"; };
+const std::string ValueType<std::string>::getStepParameter() const { std::string out; EXPRESSStepFormat::appendText(out, ValueType<std::string>::m_value); return out; };
 const std::string ValueType<boost::logic::tribool>::getStepParameter() const {
 	switch (ValueType<boost::logic::tribool>::m_value.value) {
 	case boost::logic::tribool::true_value: return "TRUE";
@@ -113,51 +129,61 @@ const std::string ValueType<boost::logic::tribool>::getStepParameter() const {
 	return "ERROR";
 }
 
+void ValueType<double>::writeStepParameter(std::string& out) const { EXPRESSStepFormat::appendReal(out, ValueType<double>::m_value); };
+void ValueType<int>::writeStepParameter(std::string& out) const { EXPRESSStepFormat::appendInteger(out, ValueType<int>::m_value); };
+void ValueType<bool>::writeStepParameter(std::string& out) const { EXPRESSStepFormat::appendLogical(out, ValueType<bool>::m_value); };
+void ValueType<std::string>::writeStepParameter(std::string& out) const { EXPRESSStepFormat::appendText(out, ValueType<std::string>::m_value); };
+void ValueType<boost::logic::tribool>::writeStepParameter(std::string& out) const {
+	switch (ValueType<boost::logic::tribool>::m_value.value) {
+	case boost::logic::tribool::true_value: out += ".T."; return;
+	case boost::logic::tribool::false_value: out += ".F."; return;
+	default: out += ".U."; return;
+	}
+}
+
 
-double ValueType<double>::readStepData(const std::string &value, const std::shared_ptr<EXPRESSModel>&) {
+double ValueType<double>::readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>&) {
 	if (value == "*") {
 		//TODO : Implement behaviour
 		return 0.0;
 	}
 	else {
-		return (stod(value));
+		return EXPRESSTokenizer::toReal(value);
 	}
 };
 
-int ValueType<int>::readStepData(const std::string &value, const std::shared_ptr<EXPRESSModel>&) { 
+int ValueType<int>::readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>&) { 
 	if (value == "*") {
 		//TODO : Implement behaviour
 		return 0;
 	}
 	else {
-		return (stoi(value));
+		return EXPRESSTokenizer::toInteger(value);
 	}
 };
 
-bool ValueType<bool>::readStepData(const std::string &value, const std::shared_ptr<EXPRESSModel>&) {
+bool ValueType<bool>::readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>&) {
 	if (value == "*") {
 		//TODO : Implement behaviour
 		return false;
 	}
 	else {
-		std::string lower = boost::algorithm::to_lower_copy(value);
-		return (lower == "true" || lower == ".t.");
+		return boost::algorithm::iequals(value, "true") || boost::algorithm::iequals(value, ".t.");
 	}
 };
 
-std::string ValueType<std::string>::readStepData(const std::string &value, const std::shared_ptr<EXPRESSModel>&) { return (value); };
+std::string ValueType<std::string>::readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>&) { return EXPRESSTokenizer::toText(value); };
 
-boost::logic::tribool ValueType<boost::logic::tribool>::readStepData(const std::string &value, const std::shared_ptr<EXPRESSModel>&) {
-	std::string lower = boost::algorithm::to_lower_copy(value);
+boost::logic::tribool ValueType<boost::logic::tribool>::readStepData(EXPRESSTokenizer::token value, const std::shared_ptr<EXPRESSModel>&) {
 	if (value == "*") {
 		//TODO : Implement behaviour
 		return boost::logic::tribool(boost::logic::indeterminate);
 	}
 	else {
-		if (lower == "true" || lower == ".t.") {
+		if (boost::algorithm::iequals(value, "true") || boost::algorithm::iequals(value, ".t.")) {
 			return boost::logic::tribool::true_value;
 		}
-		else if (lower == "false" || lower == ".f.") {
+		else if (boost::algorithm::iequals(value, "false") || boost::algorithm::iequals(value, ".f.")) {
 			return boost::logic::tribool::false_value;
 		}
 		else {
@@ -51,6 +51,9 @@ int main(int argc, char **argv) {
 		TCLAP::ValueArg<std::string> outputDirectory("o", "outputDir", "The output directory.", false, "", "string");
         cmd.add(outputDirectory);
 
+		TCLAP::ValueArg<size_t> unity("u", "unity", "Compile the generated sources in unity files of this many sources, 0 compiles them one by one.", false, 0, "number");
+        cmd.add(unity);
+
         // Parse the args.
         cmd.parse(argc, argv);
 
@@ -84,6 +87,7 @@ int main(int argc, char **argv) {
 		       
        
         GeneratorOIP cppgen(outputDirectoryName);
+        cppgen.setUnityBuild(unity.getValue());
         cppgen.generateREFACTORED(out, oip::Schema::getInstance());
         
 
@@ -22,19 +22,22 @@
 #include "GeneratorOIP.h"
 
 #include "General/namespace.h"
+#include "EXPRESS/EXPRESSTypeNameHash.h"
 //#include <Windows.h>
 #include <algorithm>
 #include <cassert>
 #include <experimental/filesystem>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <set>
 #include <sstream>
-#include <chrono>
+#include <cstdint>
 
 //#include <boost/optional.hpp>
 //#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/name_generator.hpp>
+#include <boost/uuid/string_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
 
@@ -92,7 +95,8 @@ std::string notice_cmake =
 # This file has been automatically generated using the TUM Open Infra Platform\n\
 # Early Binding EXPRESS Generator. Any changes to this file my be lost in the future.";
 
-static size_t indentation = 0;
+// Files are generated in parallel, every thread writes with its own indentation.
+static thread_local size_t indentation = 0;
 
 enum eKeepDelimCharacter {None, Left, Right, Standalone};
 std::vector<std::string> split(std::string text, char delim, eKeepDelimCharacter value)
@@ -201,6 +205,178 @@ std::string replaceAll(std::string str, const std::string &from, const std::stri
 	return str;
 }
 
+// Builds a perfect hash for the names ("hash, displace and compress"). The names are distributed into buckets by their
+// unseeded hash, then the largest buckets are placed first by searching a seed that maps all their names to free slots.
+// The hash is the one EarlyBinding::EXPRESSTypeTable looks the names up with.
+void createPerfectHash(const std::vector<std::string> &names, std::vector<uint32_t> &displacements, std::vector<int> &slots) {
+	using OpenInfraPlatform::EarlyBinding::hashTypeName;
+
+	const size_t bucketCount = std::max<size_t>(1, names.size() / 4);
+	size_t slotCount = 1;
+	while (slotCount < 2 * names.size())
+		slotCount <<= 1;
+
+	std::vector<std::vector<size_t>> buckets(bucketCount);
+	for (size_t i = 0; i < names.size(); i++)
+		buckets[hashTypeName(names[i], 0) % bucketCount].push_back(i);
+
+	std::vector<size_t> order(bucketCount);
+	for (size_t i = 0; i < bucketCount; i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+	displacements.assign(bucketCount, 0);
+	slots.assign(slotCount, -1);
+	for (size_t bucket : order) {
+		if (buckets[bucket].empty())
+			break;
+
+		for (uint32_t seed = 1; ; seed++) {
+			std::vector<size_t> positions;
+			for (size_t index : buckets[bucket]) {
+				const size_t position = hashTypeName(names[index], seed) & (slotCount - 1);
+				if (slots[position] >= 0 || std::find(positions.begin(), positions.end(), position) != positions.end())
+					break;
+				positions.push_back(position);
+			}
+
+			if (positions.size() == buckets[bucket].size()) {
+				for (size_t i = 0; i < positions.size(); i++)
+					slots[positions[i]] = static_cast<int>(buckets[bucket][i]);
+				displacements[bucket] = seed;
+				break;
+			}
+		}
+	}
+}
+
+// Describes the attributes of the entities and the definitions of the types. The readers store its hash in their binary
+// snapshots, so a snapshot written by the bindings of another schema version is ignored.
+uint64_t hashSnapshotLayout(const Schema &schema, const std::vector<std::string> &entityNames) {
+	std::string layout = schema.getName();
+	for (int idx = 0; idx < schema.getTypeCount(); idx++) {
+		const Type type = schema.getTypeByIndex(idx);
+		layout += ";" + type.getName() + "=";
+		if (type.isSelectType() || type.isEnumeration()) {
+			std::vector<std::string> types = type.getTypes();
+			layout += join(types, ',');
+		}
+		else if (type.isContainerType()) {
+			layout += type.getContainerTypeIdentifier();
+		}
+		else {
+			layout += type.getUnderlyingTypeName();
+		}
+	}
+	for (const auto& name : entityNames) {
+		layout += ";" + name + "(";
+		for (const auto& attr : schema.getAllEntityAttributes(schema.getEntityByName(name)))
+			layout += attr.toString(schema) + ",";
+		layout += ")";
+	}
+
+	uint64_t h = 14695981039346656037ull;
+	for (const char c : layout) {
+		h ^= static_cast<unsigned char>(c);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+// The attributes that are the target of an INVERSE attribute as pairs of entity and attribute name. The position in the
+// list numbers the relation in EarlyBinding::EXPRESSInverseIndex, so the entities of a schema agree on it.
+std::vector<std::pair<std::string, std::string>> getInverseRelations(const Schema &schema) {
+	std::set<std::pair<std::string, std::string>> relations;
+	for (int idx = 0; idx < schema.getEntityCount(); idx++) {
+		for (const auto& inverse : schema.getEntityByIndex(idx).getInverseAttributes())
+			relations.insert(std::make_pair(inverse.entity, inverse.attribute));
+	}
+	return std::vector<std::pair<std::string, std::string>>(relations.begin(), relations.end());
+}
+
+size_t getInverseRelation(const std::vector<std::pair<std::string, std::string>> &relations, const inverseAttribute &inverse) {
+	return std::lower_bound(relations.begin(), relations.end(), std::make_pair(inverse.entity, inverse.attribute)) - relations.begin();
+}
+
+// The relations an entity adds its references to: those of its own attributes and inherited attributes, for the
+// entity itself and its supertypes.
+std::vector<std::pair<size_t, std::string>> getInverseRelationsOf(const Schema &schema, const Entity &entity, const std::vector<std::pair<std::string, std::string>> &relations) {
+	std::vector<std::string> types = schema.getSuperTypes(entity);
+	types.push_back(entity.getName());
+	std::set<std::string> attributes;
+	for (const auto& attr : schema.getAllEntityAttributes(entity))
+		attributes.insert(attr.getName());
+
+	std::vector<std::pair<size_t, std::string>> result;
+	for (size_t k = 0; k < relations.size(); k++) {
+		if (std::find(types.begin(), types.end(), relations[k].first) != types.end() && attributes.count(relations[k].second))
+			result.push_back(std::make_pair(k, relations[k].second));
+	}
+	return result;
+}
+
+// Numbers the entity types in preorder of the inheritance tree, so the subtypes of a type directly follow it. Maps each
+// entity to its type id and the number of types in its subtree including itself, see EarlyBinding::isOfType.
+std::map<std::string, std::pair<uint32_t, uint32_t>> getEntityTypeIds(const Schema &schema) {
+	std::map<std::string, std::vector<std::string>> subtypes;
+	std::vector<std::string> roots;
+	for (int idx = 0; idx < schema.getEntityCount(); idx++) {
+		const Entity entity = schema.getEntityByIndex(idx);
+		if (entity.hasSupertype() && schema.hasEntity(entity.getSupertype()))
+			subtypes[entity.getSupertype()].push_back(entity.getName());
+		else
+			roots.push_back(entity.getName());
+	}
+
+	std::map<std::string, std::pair<uint32_t, uint32_t>> typeIds;
+	uint32_t next = 0;
+	std::function<void(const std::string&)> number = [&](const std::string &name) {
+		const uint32_t id = next++;
+		for (const auto& subtype : subtypes[name])
+			number(subtype);
+		typeIds[name] = std::make_pair(id, next - id);
+	};
+	for (const auto& root : roots)
+		number(root);
+	return typeIds;
+}
+
+// The EarlyBinding::EXPRESSAttributeKind of an attribute, for aggregates the kind of the elements.
+std::string getAttributeKind(const Schema &schema, const EntityAttribute &attr, bool &aggregate) {
+	auto type = attr.type;
+	aggregate = false;
+	while (type->getType() == eEntityAttributeParameterType::eGeneralizedType) {
+		aggregate = true;
+		type = std::static_pointer_cast<EntityAttributeGeneralizedType>(type)->elementType;
+	}
+
+	const std::string name = type->toString();
+	if (type->getType() == eEntityAttributeParameterType::Simple)
+		return "Simple";
+	if (schema.hasEntity(name))
+		return "Entity";
+	if (schema.hasType(name)) {
+		const Type definedType = schema.getTypeByName(name);
+		if (definedType.isSelectType())
+			return "Select";
+		if (definedType.isEnumeration())
+			return "Enumeration";
+		aggregate = aggregate || definedType.isContainerType();
+		return "Defined";
+	}
+	return "Simple";
+}
+
+template <typename T> void writeArrayValues(std::ostream &out, const std::vector<T> &values) {
+	for (size_t i = 0; i < values.size(); i += 16) {
+		std::string line;
+		for (size_t j = i; j < std::min(i + 16, values.size()); j++)
+			line += std::to_string(values[j]) + ", ";
+		line.pop_back();
+		writeLine(out, line);
+	}
+}
+
 void copyTemplate(const std::string &templateFilename, const std::string &outFilename, const Schema &schema) {
 	std::ofstream out(outFilename);
 	
@@ -312,6 +488,62 @@ void writeInclude(std::ostream &out, std::string filename, bool useAngleBrackets
 		writeLine(out, "#include \"" + filename + "\"");
 }
 
+// The GUID of an include guard is derived from the schema and the file, generating a schema again yields the same guard.
+std::string includeGuard(const OpenInfraPlatform::ExpressBindingGenerator::Schema &schema, const std::string &name)
+{
+	static const boost::uuids::uuid scope = boost::uuids::string_generator()("{4f1d2c3a-8e6b-4a59-b7d0-2c9e5f81a6b3}");
+	auto guid = boost::uuids::to_string(boost::uuids::name_generator(scope)(schema.getName() + "/" + name));
+	std::replace(guid.begin(), guid.end(), '-', '_');
+	std::vector<std::string> parts = { "OpenInfraPlatform", schema.getName(), name, guid, "h" };
+	return join(parts, '_');
+}
+
+// Collects the content of a generated file and replaces the file on close only if the content changed, so that the
+// build system recompiles only what is affected by a change of the schema.
+class GeneratedFile : public std::ostringstream {
+public:
+	GeneratedFile() = default;
+
+	explicit GeneratedFile(const std::string &filename) {
+		open(filename);
+	}
+
+	~GeneratedFile() {
+		close();
+	}
+
+	void open(const std::string &filename) {
+		close();
+		filename_ = filename;
+		str(std::string());
+		clear();
+	}
+
+	void close() {
+		if (filename_.empty())
+			return;
+
+		const std::string content = str();
+		std::ifstream existing(filename_);
+		if (existing) {
+			std::stringstream previous;
+			previous << existing.rdbuf();
+			if (previous.str() == content) {
+				filename_.clear();
+				return;
+			}
+			existing.close();
+		}
+
+		std::ofstream file(filename_);
+		file << content;
+		filename_.clear();
+	}
+
+private:
+	std::string filename_;
+};
+
 
 
 // Doxygen helper functions
@@ -972,7 +1204,11 @@ void resolveEntityIncludes(Schema& schema, const Entity& entity, std::set<std::s
 }
 
 
-OpenInfraPlatform::ExpressBindingGenerator::GeneratorOIP::GeneratorOIP(const std::string &outputDirectory) : outputDirectory_(outputDirectory) {
+OpenInfraPlatform::ExpressBindingGenerator::GeneratorOIP::GeneratorOIP(const std::string &outputDirectory) : outputDirectory_(outputDirectory), sourcesPerUnit_(0) {
+}
+
+void GeneratorOIP::setUnityBuild(size_t sourcesPerUnit) {
+	sourcesPerUnit_ = sourcesPerUnit;
 }
 
 
@@ -1118,6 +1354,7 @@ void GeneratorOIP::generateREFACTORED(std::ostream & out, Schema & schema)
 	entityPath_ = sourceDirectory_ + "/entity";
 	typePath_ = sourceDirectory_ + "/type";
 	readerPath_ = sourceDirectory_ + "/reader";
+	unityPath_ = sourceDirectory_ + "/unity";
 	
 
 	if (!fs::exists(rootDirectory_)) {
@@ -1144,12 +1381,17 @@ void GeneratorOIP::generateREFACTORED(std::ostream & out, Schema & schema)
 		fs::create_directory(typePath_);
 	}
 
+	if (sourcesPerUnit_ > 0 && !fs::exists(unityPath_)) {
+		fs::create_directory(unityPath_);
+	}
+
 	generateCMakeListsFileREFACTORED(schema);
 
 	generateSchemaHeader(schema);
 	generateReaderFiles(schema);
 	generateEMTFiles(schema);
 	generateNamespaceHeader(schema);
+	generateForwardHeader(schema);
 
 	// Types.h
 	createTypesHeaderFileREFACTORED(schema);
@@ -1157,18 +1399,91 @@ void GeneratorOIP::generateREFACTORED(std::ostream & out, Schema & schema)
 	// Entities.h
 	createEntitiesHeaderFileREFACTORED(schema);
 
-//#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
 	for (int i = 0; i < schema.getTypeCount(); i++) {
 		auto &type = schema.getTypeByIndex(i);
 		generateTypeHeaderFileREFACTORED(schema, type);
 		generateTypeSourceFileREFACTORED(schema, type);
 	}
 
-//#pragma omp parallel for
+	// The type ids depend on the whole inheritance tree, they are numbered once for all entity headers
+	const auto typeIds = getEntityTypeIds(schema);
+	// The inverse relations are collected from all entities, likewise once for all entity files
+	const auto inverseRelations = getInverseRelations(schema);
+
+#pragma omp parallel for schedule(dynamic)
 	for (int i = 0; i < schema.getEntityCount(); i++) {
 		auto &entity = schema.getEntityByIndex(i);
-		generateEntityHeaderFileREFACTORED(schema, entity);
-		generateEntitySourceFileREFACTORED(schema, entity);
+		generateEntityHeaderFileREFACTORED(schema, entity, typeIds, inverseRelations);
+		generateEntitySourceFileREFACTORED(schema, entity, inverseRelations);
+	}
+
+	if (sourcesPerUnit_ > 0) {
+		generateUnitySourceFiles(schema);
+	}
+
+	removeStaleFiles(schema);
+}
+
+void GeneratorOIP::removeStaleFiles(Schema & schema)
+{
+	// Files of types and entities which are no longer part of the schema would otherwise still be globbed by CMake.
+	std::set<std::string> typeFiles, entityFiles;
+	for (int i = 0; i < schema.getTypeCount(); i++) {
+		typeFiles.insert(schema.getTypeByIndex(i).getName() + ".h");
+		typeFiles.insert(schema.getTypeByIndex(i).getName() + ".cpp");
+	}
+	for (int i = 0; i < schema.getEntityCount(); i++) {
+		entityFiles.insert(schema.getEntityByIndex(i).getName() + ".h");
+		entityFiles.insert(schema.getEntityByIndex(i).getName() + ".cpp");
+	}
+
+	const size_t typeAndEntityCount = schema.getTypeCount() + schema.getEntityCount();
+	std::set<std::string> unityFiles;
+	for (size_t unit = 0; sourcesPerUnit_ > 0 && unit * sourcesPerUnit_ < typeAndEntityCount; unit++) {
+		unityFiles.insert(schema.getName() + "Unity" + std::to_string(unit) + ".cpp");
+	}
+
+	const std::vector<std::pair<std::string, const std::set<std::string>*>> directories = {
+		{ typePath_, &typeFiles }, { entityPath_, &entityFiles }, { unityPath_, &unityFiles }
+	};
+	for (const auto& directory : directories) {
+		if (!fs::exists(directory.first)) {
+			continue;
+		}
+
+		std::vector<fs::path> stale;
+		for (const auto& entry : fs::directory_iterator(directory.first)) {
+			if (!directory.second->count(entry.path().filename().string())) {
+				stale.push_back(entry.path());
+			}
+		}
+		for (const auto& path : stale) {
+			fs::remove(path);
+		}
+	}
+}
+
+void GeneratorOIP::generateUnitySourceFiles(Schema & schema)
+{
+	// Each unity file compiles a batch of type and entity sources, the headers they share are parsed once per batch.
+	std::vector<std::string> sources;
+	for (int i = 0; i < schema.getTypeCount(); i++) {
+		sources.push_back("../type/" + schema.getTypeByIndex(i).getName() + ".cpp");
+	}
+	for (int i = 0; i < schema.getEntityCount(); i++) {
+		sources.push_back("../entity/" + schema.getEntityByIndex(i).getName() + ".cpp");
+	}
+
+	for (size_t begin = 0, unit = 0; begin < sources.size(); begin += sourcesPerUnit_, unit++) {
+		GeneratedFile out(unityPath_ + "/" + schema.getName() + "Unity" + std::to_string(unit) + ".cpp");
+
+		writeLicenseAndNotice(out);
+		for (size_t i = begin; i < std::min(begin + sourcesPerUnit_, sources.size()); i++) {
+			writeInclude(out, sources[i]);
+		}
+
+		out.close();
 	}
 }
 
@@ -1241,18 +1556,12 @@ void GeneratorOIP::createTypesHeaderFileREFACTORED(Schema & schema)
 	std::stringstream ssFilename;
 
 	ssFilename << sourceDirectory_ <<  "/" << schema.getName() << "Types.h";
-	std::ofstream out(ssFilename.str());
+	GeneratedFile out(ssFilename.str());
 
 	out << license;
 	out << std::endl;
 	
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), "Types", guid, "h" }, '_');
+	std::string define = includeGuard(schema, "Types");
 
 	writeLine(out, "#pragma once");
 	writeLine(out, "#ifndef " + define);
@@ -1290,18 +1599,12 @@ void GeneratorOIP::createEntitiesHeaderFile(Schema &schema) {
 void GeneratorOIP::createEntitiesHeaderFileREFACTORED(Schema &schema) {
 	std::stringstream ssFilename;
 	ssFilename << sourceDirectory_ <<  "/" << schema.getName() << "Entities.h";
-	std::ofstream out(ssFilename.str());
+	GeneratedFile out(ssFilename.str());
 
 	out << license << std::endl;
 	out << std::endl;
 	
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), "Entities", guid, "h" }, '_');
+	std::string define = includeGuard(schema, "Entities");
 
 	writeLine(out, "#pragma once");
 	writeLine(out, "#ifndef " + define);
@@ -1609,19 +1912,13 @@ void GeneratorOIP::generateTypeHeaderFileREFACTORED(Schema & schema, Type & type
 	std::stringstream ssHeaderFilename;
 	ssHeaderFilename << typePath_ << "/" << type.getName() << ".h";
 	//std::cout << ssHeaderFilename.str() << std::endl;
-	std::ofstream out(ssHeaderFilename.str());
+	GeneratedFile out(ssHeaderFilename.str());
 
 	indentation = 0;
 
 	writeLicenseAndNotice(out);
 
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), type.getName(), guid, "h" }, '_');
+	std::string define = includeGuard(schema, type.getName());
 	
 	writeLine(out, "#pragma once");
 	writeLine(out, "#ifndef " + define);
@@ -1654,7 +1951,9 @@ void GeneratorOIP::generateTypeHeaderFileREFACTORED(Schema & schema, Type & type
 		writeInclude(out, "EXPRESS/SelectType.h");
 	}
 
+	writeInclude(out, "EXPRESS/EXPRESSOptional.h");
 	writeInclude(out, "../" + schema.getName() + "Namespace.h");
+	writeInclude(out, "../" + schema.getName() + "Forward.h");
 	
 
 	if (type.isDerivedType()) {
@@ -1691,22 +1990,6 @@ void GeneratorOIP::generateTypeHeaderFileREFACTORED(Schema & schema, Type & type
 	
 
 	writeBeginNamespace(out, schema);
-	
-	if (type.isSelectType()) {
-		//if (!types.empty()) {
-		//	for (auto val : types) {
-		//		writeLine(out,"class " + val + ";");
-		//	}
-		//	linebreak(out);
-		//}
-	
-		if (!entities.empty()) {
-			for (auto entity : entities) {
-				writeLine(out, "class " + entity + ";");
-			}
-			linebreak(out);
-		}
-	}
 
 	if (type.isSimpleType() || type.isDerivedType()) {
 		writeValueTypeFile(type, out);
@@ -1726,6 +2009,12 @@ void GeneratorOIP::generateTypeHeaderFileREFACTORED(Schema & schema, Type & type
 	}	
 
 	writeEndNamespace(out, schema);
+	linebreak(out);
+
+	// Instantiated once in the source file of the type.
+	writeLine(out, "extern template class OpenInfraPlatform::EarlyBinding::EXPRESSOptional<OpenInfraPlatform::" + schema.getName() + "::" + type.getName() + ">;");
+	linebreak(out);
+
 	writeLine(out, "#endif // end define " + define);
 	out.close();
 }
@@ -2104,7 +2393,7 @@ void GeneratorOIP::generateTypeSourceFileREFACTORED(Schema & schema, Type & type
 	std::stringstream ssSourceFilename;
 	ssSourceFilename << typePath_ << "/" << type.getName() << ".cpp";
 	//std::cout << ssHeaderFilename.str() << std::endl;
-	std::ofstream out(ssSourceFilename.str());
+	GeneratedFile out(ssSourceFilename.str());
 
 	indentation = 0;
 
@@ -2376,17 +2665,11 @@ void OpenInfraPlatform::ExpressBindingGenerator::GeneratorOIP::generateTypeSourc
 
 void GeneratorOIP::generateReaderFiles(const Schema & schema)
 {
-	std::ofstream file(readerPath_  + "/" + schema.getName().append("Reader.h"));
+	GeneratedFile file(readerPath_  + "/" + schema.getName().append("Reader.h"));
 
 	writeLicenseAndNotice(file);
 
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), schema.getName() + "Reader", guid, "h" }, '_');
+	std::string define = includeGuard(schema, schema.getName() + "Reader");
 
 	writeLine(file, "#pragma once");
 	writeLine(file, "#ifndef " + define);
@@ -2394,6 +2677,7 @@ void GeneratorOIP::generateReaderFiles(const Schema & schema)
 
 	writeInclude(file, "../EarlyBinding/src/EXPRESS/EXPRESS.h");
 	writeInclude(file, "string", true);
+	writeInclude(file, "vector", true);
 	linebreak(file);
 
 	// Write begin namespace OpenInfraPlatform::Schema
@@ -2402,7 +2686,22 @@ void GeneratorOIP::generateReaderFiles(const Schema & schema)
 	writeLine(file, "class " + schema.getName() + "Reader {"); // begin class
 	writeLine(file, "public:");
 	
-	writeLine(file, "static std::shared_ptr<EarlyBinding::EXPRESSModel> FromFile(const std::string &filename);"); 
+	writeLine(file, "// In lazy mode the attributes of an entity are decoded on first access, the model keeps the file mapped.");
+	writeLine(file, "static std::shared_ptr<EarlyBinding::EXPRESSModel> FromFile(const std::string &filename, bool lazy = false);"); 
+	linebreak(file);
+	writeLine(file, "// Reads only the entities of the given types or their subtypes, or only those of the roots which match the types.");
+	writeLine(file, "// The entities which refer to them through an INVERSE attribute of the schema are read as well, and all entities any");
+	writeLine(file, "// of these reference. For an IfcBuildingStorey its IfcRelContainedInSpatialStructure and IfcRelAggregates are read and");
+	writeLine(file, "// with them the contained products and their geometry. Relations of the products, e.g. their openings, are not followed.");
+	writeLine(file, "// Throws std::invalid_argument if a type name is unknown.");
+	writeLine(file, "static std::shared_ptr<EarlyBinding::EXPRESSModel> FromFile(const std::string &filename, const std::vector<std::string> &types, const std::vector<size_t> &roots = std::vector<size_t>(), bool lazy = false);");
+	linebreak(file);
+	writeLine(file, "// Loads only the binary snapshot of the file from the cache directory. Returns nullptr if there is none or it does not match the file.");
+	writeLine(file, "static std::shared_ptr<EarlyBinding::EXPRESSModel> FromSnapshot(const std::string &filename, const std::string &cacheDirectory);");
+	linebreak(file);
+	writeLine(file, "// Loads the binary snapshot of the file from the cache directory if it matches the file, otherwise reads the file and writes");
+	writeLine(file, "// the snapshot to the cache directory. A snapshot that cannot be written is ignored. Without a cache directory the file is only read.");
+	writeLine(file, "static std::shared_ptr<EarlyBinding::EXPRESSModel> FromFileCached(const std::string &filename, const std::string &cacheDirectory);");
 	writeLine(file, "};"); // end class
 
 	writeEndNamespace(file, schema);
@@ -2415,135 +2714,335 @@ void GeneratorOIP::generateReaderFiles(const Schema & schema)
 	writeLicenseAndNotice(file);
 	writeInclude(file, schema.getName().append("Reader.h"));
 	writeInclude(file, "../" + schema.getName() + "Entities.h");
-	writeInclude(file, "fstream", true);
+	writeInclude(file, "EXPRESS/EXPRESSMappedFile.h");
+	writeInclude(file, "EXPRESS/EXPRESSTokenizer.h");
+	writeInclude(file, "EXPRESS/EXPRESSArena.h");
+	writeInclude(file, "EXPRESS/EXPRESSExtents.h");
+	writeInclude(file, "EXPRESS/EXPRESSTypeTable.h");
+	writeInclude(file, "EXPRESS/EXPRESSLazyDecoder.h");
+	writeInclude(file, "EXPRESS/EXPRESSSnapshotFile.h");
+	writeInclude(file, "algorithm", true);
 	writeInclude(file, "exception", true);
+	writeInclude(file, "stdexcept", true);
 	linebreak(file);
 
 	writeBeginNamespace(file, schema);
 	linebreak(file);
-	/*
-	std::vector<std::string> parseArgs(const std::string &line) {
-	std::vector<std::string> args;
-	auto paramvalue = line.substr(line.find_first_of('(') + 1, line.find_last_of(')') - line.find_first_of('(') - 1);
-	std::cout << paramvalue << std::endl;
-	while (!paramvalue.empty()) {
-	auto end = paramvalue.size() - 1;
-	auto pos = paramvalue.find_first_of(',');
-	if (pos < end) {
-	if (paramvalue.find_first_of('(') < pos) {
-	auto isOpenBrace = [](char c) -> bool {return c == '('; };
-
-	while (std::count(paramvalue.begin(), paramvalue.begin() + pos, '(') != std::count(paramvalue.begin(), paramvalue.begin() + pos, ')'))
-	pos++;
-
-	args.push_back(paramvalue.substr(0, pos));
-	paramvalue.erase(0, pos + 1);
-	}
-	else {
-	args.push_back(paramvalue.substr(0, pos));
-	paramvalue.erase(0, pos + 1);
-	}
-	}
-	else {
-	args.push_back(paramvalue.substr(0, pos));
-	paramvalue.clear();
+	// Table-driven dispatch: the perfect hash maps the STEP type name to the index into the factory and reader tables.
+	std::vector<std::string> entityNames;
+	std::vector<std::string> entityTypeNames;
+	std::map<std::string, std::vector<uint32_t>> entitySubtypes;
+	for (size_t idx = 0; idx < schema.getEntityCount(); idx++) {
+		auto entity = schema.getEntityByIndex(idx);
+		entitySubtypes[toUpper(entity.getName())];
+		if (!schema.isAbstract(entity)) {
+			// The non-abstract type is a subtype of itself and of all of its supertypes.
+			for (auto ancestor = entity; ; ancestor = schema.getEntityByName(ancestor.getSupertype())) {
+				entitySubtypes[toUpper(ancestor.getName())].push_back(static_cast<uint32_t>(entityNames.size()));
+				if (!ancestor.hasSupertype())
+					break;
+			}
+
+			entityNames.push_back(entity.getName());
+			entityTypeNames.push_back(toUpper(entity.getName()));
+		}
 	}
+
+	std::vector<uint32_t> displacements;
+	std::vector<int> slots;
+	createPerfectHash(entityTypeNames, displacements, slots);
+
+	writeLine(file, "namespace {");
+	writeLine(file, "typedef void(*EntityAllocator)(EarlyBinding::EXPRESSArena&, const std::vector<size_t>&, std::vector<std::shared_ptr<EarlyBinding::EXPRESSEntity>>&);");
+	writeLine(file, "typedef void(*EntityReader)(EarlyBinding::EXPRESSEntity&, const std::vector<boost::string_view>&, const std::shared_ptr<EarlyBinding::EXPRESSModel>&);");
+	linebreak(file);
+	writeLine(file, "template <typename T> void allocateEntities(EarlyBinding::EXPRESSArena& arena, const std::vector<size_t>& indices, std::vector<std::shared_ptr<EarlyBinding::EXPRESSEntity>>& entities) {");
+	writeLine(file, "T* slab = arena.allocate<T>(indices.size());");
+	writeLine(file, "for(size_t k = 0; k < indices.size(); k++) entities[indices[k]] = arena.share(slab + k);");
+	writeLine(file, "}");
+	linebreak(file);
+	writeLine(file, "template <typename T> void readEntity(EarlyBinding::EXPRESSEntity& entity, const std::vector<boost::string_view>& args, const std::shared_ptr<EarlyBinding::EXPRESSModel>& model) {");
+	writeLine(file, "T::readStepData(static_cast<T&>(entity), args, model);");
+	writeLine(file, "}");
+	linebreak(file);
+	writeLine(file, "const char* const entityTypeNames[] = {");
+	for (auto& name : entityTypeNames)
+		writeLine(file, "\"" + name + "\",");
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const EntityAllocator entityAllocators[] = {");
+	for (auto& name : entityNames)
+		writeLine(file, "&allocateEntities<" + name + ">,");
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const EntityReader entityReaders[] = {");
+	for (auto& name : entityNames)
+		writeLine(file, "&readEntity<" + name + ">,");
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const uint32_t entityTypeDisplacements[] = {");
+	writeArrayValues(file, displacements);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const int entityTypeSlots[] = {");
+	writeArrayValues(file, slots);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const EarlyBinding::EXPRESSTypeTable entityTypes(entityTypeNames, entityTypeDisplacements, " + std::to_string(displacements.size()) + ", entityTypeSlots, " + std::to_string(slots.size()) + ");");
+	linebreak(file);
+	// All entity types in ascending order of their names with the non-abstract types which are the type or a subtype of it.
+	std::vector<size_t> entitySubtypeOffsets(1, 0);
+	std::vector<uint32_t> entitySubtypeIndices;
+	writeLine(file, "const char* const entitySubtypeNames[] = {");
+	for (auto& subtypes : entitySubtypes) {
+		writeLine(file, "\"" + subtypes.first + "\",");
+		entitySubtypeIndices.insert(entitySubtypeIndices.end(), subtypes.second.begin(), subtypes.second.end());
+		entitySubtypeOffsets.push_back(entitySubtypeIndices.size());
+	}
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const size_t entitySubtypeOffsets[] = {");
+	writeArrayValues(file, entitySubtypeOffsets);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const uint32_t entitySubtypeIndices[] = {");
+	writeArrayValues(file, entitySubtypeIndices);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const EarlyBinding::EXPRESSSubtypeTable entitySubtypes(entitySubtypeNames, " + std::to_string(entitySubtypes.size()) + ", entitySubtypeOffsets, entitySubtypeIndices);");
+	linebreak(file);
+	// For every non-abstract type the non-abstract types which refer to it through an INVERSE attribute of the type or
+	// one of its supertypes, e.g. IfcRelContainedInSpatialStructure for IfcBuildingStorey.
+	std::vector<size_t> inverseReferrerOffsets(1, 0);
+	std::vector<uint32_t> inverseReferrerIndices;
+	for (auto& name : entityNames) {
+		std::vector<std::string> types = schema.getSuperTypes(schema.getEntityByName(name));
+		types.push_back(name);
+		std::set<uint32_t> referrers;
+		for (auto& type : types) {
+			for (auto& inverse : schema.getEntityByName(type).getInverseAttributes()) {
+				auto subtypes = entitySubtypes.find(toUpper(inverse.entity));
+				if (subtypes != entitySubtypes.end())
+					referrers.insert(subtypes->second.begin(), subtypes->second.end());
+			}
+		}
+		inverseReferrerIndices.insert(inverseReferrerIndices.end(), referrers.begin(), referrers.end());
+		inverseReferrerOffsets.push_back(inverseReferrerIndices.size());
 	}
-	return args;
-	};
-	*/
+	writeLine(file, "const size_t inverseReferrerOffsets[] = {");
+	writeArrayValues(file, inverseReferrerOffsets);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const uint32_t inverseReferrerIndices[] = {");
+	if (inverseReferrerIndices.empty())
+		writeLine(file, "0"); // an array must not be empty, it is never read
+	writeArrayValues(file, inverseReferrerIndices);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "bool isInverseReferrer(int referring, int referenced) {"); // begin function isInverseReferrer
+	writeLine(file, "return referring >= 0 && referenced >= 0 && std::binary_search(inverseReferrerIndices + inverseReferrerOffsets[referenced], inverseReferrerIndices + inverseReferrerOffsets[referenced + 1], static_cast<uint32_t>(referring));");
+	writeLine(file, "}"); // end function isInverseReferrer
+	linebreak(file);
+	// The snapshot numbers the non-abstract types like the type table, the entities report their generated type id.
+	std::vector<int> entityTypeIndices(schema.getEntityCount(), -1);
+	const auto typeIds = getEntityTypeIds(schema);
+	for (size_t type = 0; type < entityNames.size(); type++)
+		entityTypeIndices[typeIds.at(entityNames[type]).first] = static_cast<int>(type);
+	writeLine(file, "const int entityTypeIndexByTypeId[] = {");
+	writeArrayValues(file, entityTypeIndices);
+	writeLine(file, "};");
+	linebreak(file);
+	writeLine(file, "const uint64_t snapshotLayout = " + std::to_string(hashSnapshotLayout(schema, entityNames)) + "ull;");
+	linebreak(file);
 
-	writeLine(file, "std::vector<std::string> parseArgs(const std::string &line) {");
-	writeLine(file, "std::vector<std::string> args;");
-	writeLine(file, "args.push_back(line.substr(1, line.find_first_of('=') - 1));");
-	writeLine(file, "auto paramvalue = line.substr(line.find_first_of('(') + 1, line.find_last_of(')') - line.find_first_of('(') - 1);");
-	writeLine(file, "while(!paramvalue.empty()) {");
-	writeLine(file, "auto end = paramvalue.size() - 1;");
-	writeLine(file, "auto pos = paramvalue.find_first_of(',');");
-	writeLine(file, "if (pos < end) {"); // begin if
-	writeLine(file, "auto textStart = paramvalue.find_first_of('\\\'');");
-	writeLine(file, "if (textStart < pos) {"); // begin if
-	writeLine(file, "auto textEnd = paramvalue.substr(textStart + 1, paramvalue.size() - textStart - 1).find_first_of('\\\'') + textStart + 1;");
-	writeLine(file, "pos = paramvalue.substr(textEnd, paramvalue.size() - textEnd).find_first_of(',') + textEnd;");
-	writeLine(file, "} else if(paramvalue.find_first_of('(') < pos) {"); //end if begin else if
-	writeLine(file, "while (std::count(paramvalue.begin(), paramvalue.begin() + pos, '(') != std::count(paramvalue.begin(), paramvalue.begin() + pos, ')')) pos++;");
-	writeLine(file, "}"); // end else if
-	writeLine(file, "args.push_back(paramvalue.substr(0, pos));");
-	writeLine(file, "paramvalue.erase(0, pos + 1);");
-	writeLine(file, "}"); // end if
-	writeLine(file, "else {"); // begin else
-	writeLine(file, "args.push_back(paramvalue.substr(0, pos));");
-	writeLine(file, "paramvalue.clear();");
-	writeLine(file, "}"); // end else
-	writeLine(file, "}"); // end while !paramvalue.empty()
-	writeLine(file, "return args;");
-	writeLine(file, "};"); // end function parseArgs
+	// Link pass: the references are resolved once all entities are read, afterwards they are immutable.
+	writeLine(file, "void linkEntities(const std::string& filename, const std::vector<std::shared_ptr<EarlyBinding::EXPRESSEntity>>& entities, const EarlyBinding::EXPRESSModel& model) {"); // begin function linkEntities
+	writeLine(file, "std::vector<size_t> unresolved;");
+	writeLine(file, "#pragma omp parallel");
+	writeLine(file, "{"); // begin parallel region
+	writeLine(file, "std::vector<size_t> unresolvedByThread;");
+	writeLine(file, "#pragma omp for");
+	writeLine(file, "for(long i = 0; i < entities.size(); i++) {"); // begin for link references
+	writeLine(file, "if(entities[i]) entities[i]->linkReferences(model, unresolvedByThread);");
+	writeLine(file, "}"); //end for link references
+	writeLine(file, "#pragma omp critical");
+	writeLine(file, "unresolved.insert(unresolved.end(), unresolvedByThread.begin(), unresolvedByThread.end());");
+	writeLine(file, "}"); //end parallel region
+	writeLine(file, "if(!unresolved.empty()) {"); // begin if unresolved
+	writeLine(file, "std::sort(unresolved.begin(), unresolved.end());");
+	writeLine(file, "unresolved.erase(std::unique(unresolved.begin(), unresolved.end()), unresolved.end());");
+	writeLine(file, "std::cout << filename << \": \" << unresolved.size() << \" referenced entities are missing or of an unexpected type:\";");
+	writeLine(file, "for(size_t i = 0; i < unresolved.size() && i < 20; i++) std::cout << \" #\" << unresolved[i];");
+	writeLine(file, "std::cout << (unresolved.size() > 20 ? \" ...\" : \"\") << std::endl;");
+	writeLine(file, "}"); //end if unresolved
+	// Inverse pass: the entities referencing each entity are indexed once the references are resolved.
+	writeLine(file, "model.inverses();");
+	writeLine(file, "}"); // end function linkEntities
+	writeLine(file, "} // end anonymous namespace");
 	linebreak(file);
 
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> " + schema.getName().append("Reader") + "::FromFile(const std::string &filename, bool lazy) {"); // begin function FromFile
+	writeLine(file, "return FromFile(filename, std::vector<std::string>(), std::vector<size_t>(), lazy);");
+	writeLine(file, "}"); // end function FromFile
+	linebreak(file);
 
-	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> " + schema.getName().append("Reader") + "::FromFile(const std::string &filename) {"); // begin function FromFile
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> " + schema.getName().append("Reader") + "::FromFile(const std::string &filename, const std::vector<std::string> &typeFilter, const std::vector<size_t> &roots, bool lazy) {"); // begin function FromFile
+	// Unknown type names are reported to the caller before the file is read, the read errors below are only logged.
+	writeLine(file, "for(const std::string& name : typeFilter) {"); // begin for check type filter
+	writeLine(file, "if(entitySubtypes.find(name) < 0) throw std::invalid_argument(\"Unknown entity type \" + name + \" in the type filter.\");");
+	writeLine(file, "}"); //end for check type filter
 
-	writeLine(file, "std::ifstream file(filename, std::ifstream::in);");
-	writeLine(file, "if(file.is_open()) {"); // begin if(file.is_open())
+	// The file is mapped into memory and tokenized in place, statements and arguments are spans into the mapping.
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSMappedFile> file = std::make_shared<EarlyBinding::EXPRESSMappedFile>(filename);");
 	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> model = std::make_shared<EarlyBinding::EXPRESSModel>(\"" + schema.getName() + "\");");
-	writeLine(file, "std::string lineInFile = \"\";");
-	writeLine(file, "std::vector<std::string> lines;");
+	writeLine(file, "std::vector<EarlyBinding::EXPRESSTokenizer::Instance> instances = EarlyBinding::EXPRESSTokenizer::index(file->view());");
+	writeLine(file, "std::vector<int> types(instances.size());");
 	writeLine(file, "try {");
-	writeLine(file, "while (!std::getline(file, lineInFile).eof()) lines.push_back(lineInFile);");
-	writeLine(file, "for(long i = 0; i < lines.size(); i++) {"); // begin for read file
-	writeLine(file, "auto line = lines[i];");
-	writeLine(file, "if(line == \"\") continue;");
-	writeLine(file, "line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());");
-	writeLine(file, "if(line[0] == '#') {");
-	writeLine(file, "const size_t id = std::stoull(line.substr(1, line.find_first_of('=') - 1));");
-	writeLine(file, "const std::string entityType = line.substr(line.find_first_of('=') + 1, line.find_first_of('(') - line.find_first_of('=') - 1);");
-	writeLine(file, "std::string parameters = line.substr(line.find_first_of('('), line.find_last_of(')') - line.find_first_of('(') + 1);");
-	for (size_t idx = 0; idx < schema.getEntityCount(); idx++) {
-		auto entity = schema.getEntityByIndex(idx);
-		if (!schema.isAbstract(entity)) {
-			writeLine(file, "if(entityType == \"" + toUpper(entity.getName()) + "\") {");
-			//writeLine(file, "std::shared_ptr<" + entity.getName() + "> entity = std::make_shared<" + entity.getName() + ">(" + entity.getName() + "::readStepData(parseArgs(line), model));"); //TODO
-			writeLine(file, "model->entities.insert({id, std::make_shared<" + entity.getName() + ">()});");
-			writeLine(file, "continue;");
-			writeLine(file, "}");
-		}
-	}
-	writeLine(file, "}"); //end if line[0] == '#'
-	writeLine(file, "}"); //end for read file
+	writeLine(file, "#pragma omp parallel for");
+	writeLine(file, "for(long i = 0; i < instances.size(); i++) {"); // begin for find types
+	writeLine(file, "types[i] = entityTypes.find(instances[i].type);");
+	writeLine(file, "}"); //end for find types
 
+	// Selective loading: only the matching entities and the entities they reference are kept, all others are never read.
 	linebreak(file);
+	writeLine(file, "if(!typeFilter.empty() || !roots.empty()) {"); // begin if selective
+	writeLine(file, "std::vector<char> matchingTypes(" + std::to_string(entityNames.size()) + ", typeFilter.empty());");
+	writeLine(file, "for(const std::string& name : typeFilter) {"); // begin for type filter
+	writeLine(file, "const int index = entitySubtypes.find(name);");
+	writeLine(file, "for(const uint32_t* type = entitySubtypes.subtypesBegin(index); type != entitySubtypes.subtypesEnd(index); ++type) matchingTypes[*type] = true;");
+	writeLine(file, "}"); //end for type filter
+	writeLine(file, "std::vector<size_t> rootIds(roots);");
+	writeLine(file, "std::sort(rootIds.begin(), rootIds.end());");
+	writeLine(file, "std::vector<char> selected(instances.size());");
+	writeLine(file, "for(size_t i = 0; i < instances.size(); i++)");
+	writeLine(file, "selected[i] = types[i] >= 0 && matchingTypes[types[i]] && (rootIds.empty() || std::binary_search(rootIds.begin(), rootIds.end(), instances[i].id));");
+	// The relations of the matched entities only refer to them, they are found through the INVERSE attributes of the schema.
+	writeLine(file, "EarlyBinding::EXPRESSTokenizer::selectReferring(instances, selected, [&types](size_t referring, size_t referenced) { return isInverseReferrer(types[referring], types[referenced]); });");
+	writeLine(file, "EarlyBinding::EXPRESSTokenizer::selectReferenced(instances, selected);");
+	writeLine(file, "size_t count = 0;");
+	writeLine(file, "for(size_t i = 0; i < instances.size(); i++) {"); // begin for compact
+	writeLine(file, "if(selected[i]) {");
+	writeLine(file, "instances[count] = instances[i];");
+	writeLine(file, "types[count++] = types[i];");
+	writeLine(file, "}");
+	writeLine(file, "}"); //end for compact
+	writeLine(file, "instances.resize(count);");
+	writeLine(file, "types.resize(count);");
+	writeLine(file, "}"); //end if selective
+	writeLine(file, "std::vector<std::shared_ptr<EarlyBinding::EXPRESSEntity>> entities(instances.size());");
+
+	// Entities of one type are constructed once in a single slab of the model's arena. In lazy mode the slab of a type
+	// is allocated by the decoder when the first of its entities is accessed.
+	linebreak(file);
+	writeLine(file, "std::vector<std::vector<size_t>> instancesByType(" + std::to_string(entityNames.size()) + ");");
+	writeLine(file, "for(size_t i = 0; i < instances.size(); i++) if(types[i] >= 0) instancesByType[types[i]].push_back(i);");
+	writeLine(file, "if(!lazy) {"); // begin if not lazy
+	writeLine(file, "#pragma omp parallel for schedule(dynamic)");
+	writeLine(file, "for(long type = 0; type < instancesByType.size(); type++) {"); // begin for allocate slabs
+	writeLine(file, "if(!instancesByType[type].empty()) entityAllocators[type](*model->arena, instancesByType[type], entities);");
+	writeLine(file, "}"); //end for allocate slabs
+	writeLine(file, "}"); //end if not lazy
+
+	// STEP ids are nearly dense, the model stores them in slots indexed by id which are filled concurrently.
+	linebreak(file);
+	writeLine(file, "size_t maxId = 0;");
+	writeLine(file, "for(const auto& instance : instances) maxId = std::max(maxId, instance.id);");
+	writeLine(file, "model->entities.reserve(maxId, instances.size());");
 	writeLine(file, "#pragma omp parallel for");
-	writeLine(file, "for(long i = 0; i < lines.size(); i++) {"); // begin for read file
-	writeLine(file, "auto line = lines[i];");
-	writeLine(file, "if(line == \"\") continue;");
-	writeLine(file, "line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());");
-	writeLine(file, "if(line[0] == '#') {");
-	writeLine(file, "const size_t id = std::stoull(line.substr(1, line.find_first_of('=') - 1));");
-	writeLine(file, "const std::string entityType = line.substr(line.find_first_of('=') + 1, line.find_first_of('(') - line.find_first_of('=') - 1);");
-	writeLine(file, "std::string parameters = line.substr(line.find_first_of('('), line.find_last_of(')') - line.find_first_of('(') + 1);");
-	for (size_t idx = 0; idx < schema.getEntityCount(); idx++) {
-		auto entity = schema.getEntityByIndex(idx);
-		if (!schema.isAbstract(entity)) {
-			writeLine(file, "if(entityType == \"" + toUpper(entity.getName()) + "\") {");
-			writeLine(file, "model->entities.find(id)->second = std::make_shared<" + entity.getName() + ">(" + entity.getName() + "::readStepData(parseArgs(line), model));");
-			writeLine(file, "continue;");
-			writeLine(file, "}");
-		}
-	}
-	writeLine(file, "}"); //end if line[0] == '#'
-	writeLine(file, "}"); //end for read file
+	writeLine(file, "for(long i = 0; i < instances.size(); i++) {"); // begin for insert entities
+	writeLine(file, "if(types[i] >= 0) model->entities.insertConcurrent(instances[i].id, entities[i]);");
+	writeLine(file, "}"); //end for insert entities
+	writeLine(file, "model->entities.endConcurrentInsertion();");
+	writeLine(file, "model->extents = EarlyBinding::EXPRESSExtents(entitySubtypes, instancesByType, [&instances](size_t i) { return instances[i].id; });");
+
+	// In lazy mode the ids are inserted without entities, the decoder allocates and reads them on first access instead.
+	// The arena owns the decoder, so the statements stay valid as long as any entity.
+	linebreak(file);
+	writeLine(file, "if(lazy) {"); // begin if lazy
+	writeLine(file, "model->lazyDecoder = std::make_shared<EarlyBinding::EXPRESSLazyDecoder>(file, model, instances, instancesByType, entityAllocators, entityReaders);");
+	writeLine(file, "model->arena->retain(model->lazyDecoder);");
+	writeLine(file, "model->entities.setLoader(model->lazyDecoder.get());");
+	writeLine(file, "return model;");
+	writeLine(file, "}"); //end if lazy
+
+	// The attributes are read into the allocated entities, so references resolved by other threads stay valid.
+	// Exceptions must not leave the parallel region, the first one is rethrown after it.
+	linebreak(file);
+	writeLine(file, "std::exception_ptr error;");
+	writeLine(file, "#pragma omp parallel");
+	writeLine(file, "{"); // begin parallel region
+	writeLine(file, "std::vector<boost::string_view> args;");
+	writeLine(file, "#pragma omp for");
+	writeLine(file, "for(long i = 0; i < instances.size(); i++) {"); // begin for read attributes
+	writeLine(file, "if(types[i] >= 0) {");
+	writeLine(file, "try {");
+	writeLine(file, "EarlyBinding::EXPRESSTokenizer::splitArguments(instances[i].statement, args);");
+	writeLine(file, "entityReaders[types[i]](*entities[i], args, model);");
+	writeLine(file, "}"); //end try
+	writeLine(file, "catch(...) {"); // begin catch
+	writeLine(file, "#pragma omp critical");
+	writeLine(file, "if(!error) error = std::current_exception();");
+	writeLine(file, "}"); //end catch
+	writeLine(file, "}");
+	writeLine(file, "}"); //end for read attributes
+	writeLine(file, "}"); //end parallel region
+	writeLine(file, "if(error) std::rethrow_exception(error);");
+
 	linebreak(file);
+	writeLine(file, "linkEntities(filename, entities, *model);");
 	writeLine(file, "return model;");
 	writeLine(file, "}"); //end try 
 	writeLine(file, "catch(std::exception e) {"); // begin catch
 	writeLine(file, "std::cout << e.what() << std::endl;");
 	writeLine(file, "}"); //end catch 
-	writeLine(file, "}");
-	writeLine(file, "else {");
-	writeLine(file, "throw std::exception(\"Could not open file.\");");
-	writeLine(file, "}"); // end else if(file.is_open())
 	writeLine(file, "return nullptr;");
 	writeLine(file, "};"); // end function FromFile
+	linebreak(file);
+
+	// The snapshot holds the entities grouped by type, every type is allocated in one slab and read without parsing.
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> " + schema.getName().append("Reader") + "::FromSnapshot(const std::string &filename, const std::string &cacheDirectory) {"); // begin function FromSnapshot
+	writeLine(file, "if(cacheDirectory.empty()) return nullptr;");
+	writeLine(file, "const EarlyBinding::EXPRESSSnapshotFile snapshot(filename, cacheDirectory, \"" + schema.getName() + "\", snapshotLayout);");
+	writeLine(file, "try {");
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> model = std::make_shared<EarlyBinding::EXPRESSModel>(\"" + schema.getName() + "\");");
+	writeLine(file, "std::vector<std::shared_ptr<EarlyBinding::EXPRESSEntity>> entities;");
+	writeLine(file, "std::vector<std::vector<size_t>> instancesByType(" + std::to_string(entityNames.size()) + ");");
+	writeLine(file, "auto allocate = [&model, &instancesByType](uint32_t type, const std::vector<size_t>& indices, std::vector<std::shared_ptr<EarlyBinding::EXPRESSEntity>>& entities) {"); // begin lambda allocate
+	writeLine(file, "entityAllocators[type](*model->arena, indices, entities);");
+	writeLine(file, "#pragma omp critical");
+	writeLine(file, "instancesByType[type].insert(instancesByType[type].end(), indices.begin(), indices.end());");
+	writeLine(file, "};"); // end lambda allocate
+	writeLine(file, "if(snapshot.read(*model, entities, " + std::to_string(entityNames.size()) + ", allocate)) {"); // begin if snapshot
+	writeLine(file, "model->extents = EarlyBinding::EXPRESSExtents(entitySubtypes, instancesByType, [&entities](size_t i) { return entities[i]->getId(); });");
+	writeLine(file, "linkEntities(filename, entities, *model);");
+	writeLine(file, "return model;");
+	writeLine(file, "}"); //end if snapshot
+	writeLine(file, "}"); //end try
+	writeLine(file, "catch(std::exception e) {"); // begin catch
+	writeLine(file, "std::cout << e.what() << std::endl;");
+	writeLine(file, "}"); //end catch
+	writeLine(file, "return nullptr;");
+	writeLine(file, "}"); // end function FromSnapshot
+	linebreak(file);
+
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> " + schema.getName().append("Reader") + "::FromFileCached(const std::string &filename, const std::string &cacheDirectory) {"); // begin function FromFileCached
+	writeLine(file, "if(cacheDirectory.empty()) return FromFile(filename);");
+	writeLine(file, "std::shared_ptr<EarlyBinding::EXPRESSModel> model = FromSnapshot(filename, cacheDirectory);");
+	writeLine(file, "if(model) return model;");
+	linebreak(file);
+	writeLine(file, "const EarlyBinding::EXPRESSSnapshotFile snapshot(filename, cacheDirectory, \"" + schema.getName() + "\", snapshotLayout);");
+	writeLine(file, "model = FromFile(filename);");
+	writeLine(file, "if(model) {"); // begin if model
+	writeLine(file, "try {");
+	writeLine(file, "auto typeOf = [](const EarlyBinding::EXPRESSEntity& entity) { return entity.typeId() < " + std::to_string(schema.getEntityCount()) + " ? entityTypeIndexByTypeId[entity.typeId()] : -1; };");
+	writeLine(file, "if(!snapshot.write(*model, " + std::to_string(entityNames.size()) + ", typeOf)) std::cout << \"Could not write \" << snapshot.getPath() << std::endl;");
+	writeLine(file, "}"); //end try
+	writeLine(file, "catch(std::exception e) {"); // begin catch
+	writeLine(file, "std::cout << \"Could not write \" << snapshot.getPath() << \": \" << e.what() << std::endl;");
+	writeLine(file, "}"); //end catch
+	writeLine(file, "}"); //end if model
+	writeLine(file, "return model;");
+	writeLine(file, "}"); // end function FromFileCached
 	writeEndNamespace(file, schema);
 
 	file.close();
@@ -2552,16 +3051,10 @@ void GeneratorOIP::generateReaderFiles(const Schema & schema)
 
 void GeneratorOIP::generateEMTFiles(const Schema & schema)
 {
-	std::ofstream file(sourceDirectory_ + "/EMTBasic" + schema.getName().append("EntityTypes.h"));
+	GeneratedFile file(sourceDirectory_ + "/EMTBasic" + schema.getName().append("EntityTypes.h"));
 
 	writeLicenseAndNotice(file);
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), "EMTBasic" + schema.getName() + "EntityTypes", guid, "h" }, '_');
+	std::string define = includeGuard(schema, "EMTBasic" + schema.getName() + "EntityTypes");
 
 	writeLine(file, "#pragma once");
 	writeLine(file, "#ifndef " + define);
@@ -2593,12 +3086,7 @@ void GeneratorOIP::generateEMTFiles(const Schema & schema)
 
 	file.open(sourceDirectory_ + "/EMT" + schema.getName().append("EntityTypes.h"));
 
-	now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	gen = boost::uuids::basic_random_generator<boost::mt19937>(&ran);
-	guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), "EMT" + schema.getName() + "EntityTypes", guid, "h" }, '_');
+	define = includeGuard(schema, "EMT" + schema.getName() + "EntityTypes");
 	writeLicenseAndNotice(file);
 
 	writeLine(file, "#pragma once");
@@ -2606,19 +3094,9 @@ void GeneratorOIP::generateEMTFiles(const Schema & schema)
 	writeLine(file, "#define " + define);
 
 	writeInclude(file, "EMTBasic" + schema.getName().append("EntityTypes.h"));
+	writeInclude(file, schema.getName() + "Forward.h");
 	//writeInclude(file, schema.getName() + "Entities.h");
 	//writeInclude(file, schema.getName() + "Types.h");
-
-	writeBeginNamespace(file, schema);
-
-	for (size_t idx = 0; idx < schema.getEntityCount(); idx++) {
-		writeLine(file, "class " + schema.getEntityByIndex(idx).getName() + ";");
-	}
-	for (size_t idx = 0; idx < schema.getTypeCount(); idx++) {
-		writeLine(file, "class " + schema.getTypeByIndex(idx).getName() + ";");
-	}
-
-	writeEndNamespace(file, schema);
 	linebreak(file);
 
 	writeLine(file, "namespace emt {"); // begin namespace emt
@@ -2838,7 +3316,7 @@ void GeneratorOIP::generateCMakeListsFileREFACTORED(const Schema & schema)
 
 	std::stringstream ssFilename;
 	ssFilename << rootDirectory_ << "/" << name;
-	std::ofstream file(ssFilename.str());
+	GeneratedFile file(ssFilename.str());
 
 	file << license_cmake << std::endl;
 	file << std::endl;
@@ -2872,6 +3350,11 @@ void GeneratorOIP::generateCMakeListsFileREFACTORED(const Schema & schema)
 	file << "file(GLOB OpenInfraPlatform_" << schema.getName()
 		<< "_reader_Source         "
 		"src/reader/*.*)" << std::endl;
+	if (sourcesPerUnit_ > 0) {
+		file << "file(GLOB OpenInfraPlatform_" << schema.getName()
+			<< "_unity_Source         "
+			"src/unity/*.*)" << std::endl;
+	}
 
 	file << "" << std::endl;
 
@@ -2879,6 +3362,11 @@ void GeneratorOIP::generateCMakeListsFileREFACTORED(const Schema & schema)
 	file << "set_property(SOURCE ${OpenInfraPlatform_" << schema.getName() << "_entity_Source} PROPERTY GENERATED ON)" << std::endl;
 	file << "set_property(SOURCE ${OpenInfraPlatform_" << schema.getName() << "_type_Source} PROPERTY GENERATED ON)" << std::endl;
 	file << "set_property(SOURCE ${OpenInfraPlatform_" << schema.getName() << "_reader_Source} PROPERTY GENERATED ON)" << std::endl;
+	if (sourcesPerUnit_ > 0) {
+		file << "set_property(SOURCE ${OpenInfraPlatform_" << schema.getName() << "_unity_Source} PROPERTY GENERATED ON)" << std::endl;
+		// The type and entity sources stay in the project, but are only compiled as part of the unity files.
+		file << "set_property(SOURCE ${OpenInfraPlatform_" << schema.getName() << "_entity_Source} ${OpenInfraPlatform_" << schema.getName() << "_type_Source} PROPERTY HEADER_FILE_ONLY ON)" << std::endl;
+	}
 
 	file << "" << std::endl;
 
@@ -2903,6 +3391,12 @@ void GeneratorOIP::generateCMakeListsFileREFACTORED(const Schema & schema)
 		<< "\\\\reader          FILES "
 		"${OpenInfraPlatform_"
 		<< schema.getName() << "_reader_Source})" << std::endl;
+	if (sourcesPerUnit_ > 0) {
+		file << "source_group(OpenInfraPlatform\\\\" << schema.getName()
+			<< "\\\\unity          FILES "
+			"${OpenInfraPlatform_"
+			<< schema.getName() << "_unity_Source})" << std::endl;
+	}
 	
 	file << "" << std::endl;
 
@@ -2917,6 +3411,10 @@ void GeneratorOIP::generateCMakeListsFileREFACTORED(const Schema & schema)
 		<< "${OpenInfraPlatform_" << schema.getName() << "_type_Source}" << std::endl;	
 	file << "\t"
 		<< "${OpenInfraPlatform_" << schema.getName() << "_reader_Source}" << std::endl;
+	if (sourcesPerUnit_ > 0) {
+		file << "\t"
+			<< "${OpenInfraPlatform_" << schema.getName() << "_unity_Source}" << std::endl;
+	}
 	file << ")" << std::endl;
 
 	file << "" << std::endl;
@@ -3301,24 +3799,18 @@ void GeneratorOIP::generateEntityHeaderFile(OpenInfraPlatform::ExpressBindingGen
 }
 
 
-void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity & entity)
+void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity & entity, const std::map<std::string, std::pair<uint32_t, uint32_t>> &typeIds, const std::vector<std::pair<std::string, std::string>> &inverseRelations)
 {
 	std::stringstream ssHeaderFilename;
 	ssHeaderFilename << entityPath_ << "/" << entity.getName() << ".h";
 	//std::cout << ssHeaderFilename.str() << std::endl;
-	std::ofstream out(ssHeaderFilename.str());
+	GeneratedFile out(ssHeaderFilename.str());
 
 	indentation = 0;
 
 	writeLicenseAndNotice(out);
 
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), entity.getName(), guid, "h" }, '_');
+	std::string define = includeGuard(schema, entity.getName());
 
 	writeLine(out, "#pragma once");
 	writeLine(out, "#ifndef " + define);
@@ -3329,6 +3821,7 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 	writeInclude(out, "visit_struct/visit_struct.hpp", true);
 	linebreak(out);
 	writeInclude(out, "../" + schema.getName() + "Namespace.h");
+	writeInclude(out, "../" + schema.getName() + "Forward.h");
 	linebreak(out);
 	writeInclude(out, "utility", true);
 	linebreak(out);
@@ -3342,54 +3835,28 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 
 	auto attributes = entity.getAttributes();
 
-	std::set<std::string> typeAttributes, entityAttributes;
+	// The referenced entities are declared in the forward header, only the types are included.
+	std::set<std::string> typeAttributes;
 
 	for (auto attr : attributes) {
 		if (attr.type->getType() == eEntityAttributeParameterType::TypeNamed) {
-			if (schema.hasEntity(attr.type->toString())) {
-				entityAttributes.insert(attr.type->toString());
-			}
 			if (schema.hasType(attr.type->toString())) {
 				typeAttributes.insert(attr.type->toString());
 			}
 		}
 		else if (attr.type->getType() == eEntityAttributeParameterType::eGeneralizedType) {
 			auto elementType = attr.type;
-			int dim = 0;
 
 			while (elementType->getType() == eEntityAttributeParameterType::eGeneralizedType) {
-				dim++;
 				elementType = std::static_pointer_cast<EntityAttributeGeneralizedType>(elementType)->elementType;
 			}
 
-			if (schema.hasEntity(elementType->toString())) {
-				entityAttributes.insert(elementType->toString());
-			}
 			if (schema.hasType(elementType->toString())) {
 				typeAttributes.insert(elementType->toString());
 			}
 		}
 	}	
 
-	//for (auto typeName : typeAttributes) {
-	//	auto type = schema.getTypeByName(typeName);		
-	//	if (type.isSelectType()) {
-	//		resolveIncludes(schema, entity, entityAttributes, type);
-	//	}
-	//}
-
-	auto self = entityAttributes.find(entity.getName());
-	if (self != entityAttributes.end()) {
-		entityAttributes.erase(self);
-	}
-
-	//if (!entityAttributes.empty()) {
-	//	for (auto entityAttribute : entityAttributes) {
-	//		writeInclude(out, entityAttribute + ".h");
-	//	}
-	//	linebreak(out);
-	//}
-	
 	if (!typeAttributes.empty()) {
 		for (auto type : typeAttributes) {
 			writeInclude(out, "../type/" + type + ".h");
@@ -3401,22 +3868,22 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 	std::string supertype = entity.hasSupertype() ? entity.getSupertype() : "EarlyBinding::EXPRESSEntity";
 	
 	writeBeginNamespace(out, schema);
-	
-	if (!entityAttributes.empty()) {
-		for (auto entityAttribute : entityAttributes) {
-			writeLine(out,"class " + entityAttribute + ";");
-		}
-		linebreak(out);
-	}
 
 	writeLine(out, "class " + entity.getName() + " : public " + supertype + " {");
 	writeLine(out, "private:");
 	writeLine(out, "using base = " + supertype + ";");
 	writeLine(out, "public:");
+
+	const auto typeId = typeIds.at(entity.getName());
+	writeLine(out, "static constexpr uint32_t TypeId = " + std::to_string(typeId.first) + ";");
+	writeLine(out, "static constexpr uint32_t SubtypeCount = " + std::to_string(typeId.second) + ";");
+	linebreak(out);
 	
 	//writeLine(out, "typedef " + entity.getName() + " UnderlyingType;");
 	
-	auto initClassAsDefault = [&out, &entity, &schema]() {
+	const auto entityRelations = getInverseRelationsOf(schema, entity, inverseRelations);
+
+	auto initClassAsDefault = [&out, &entity, &schema, &entityRelations]() {
 		// Default constructor.
 		writeLine(out, entity.getName() + "();");
 
@@ -3440,16 +3907,30 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 
 		//Classname function
 		writeLine(out, "virtual const std::string classname() const override;");
+		writeLine(out, "virtual uint32_t typeId() const override { return TypeId; }");
 		linebreak(out); 
 
 		auto attributes = schema.getAllEntityAttributes(entity);
 
-		writeLine(out, "static " + entity.getName() + " readStepData(const std::vector<std::string>& args, const std::shared_ptr<EarlyBinding::EXPRESSModel>& model);");		
+		writeLine(out, "static void readStepData(" + entity.getName() + "& entity, const std::vector<boost::string_view>& args, const std::shared_ptr<EarlyBinding::EXPRESSModel>& model);");		
+		linebreak(out);
+
+		writeLine(out, "virtual void linkReferences(const EarlyBinding::EXPRESSModel& model, std::vector<size_t>& unresolved) override;");
+		linebreak(out);
+
+		writeLine(out, "virtual void writeSnapshot(EarlyBinding::EXPRESSSnapshotWriter& out) const override;");
+		writeLine(out, "virtual void readSnapshot(EarlyBinding::EXPRESSSnapshotReader& in) override;");
 		linebreak(out);
 
 		writeLine(out, "virtual const std::string getStepLine() const override;");
+		writeLine(out, "virtual void writeStepLine(std::string& out) const override;");
 		linebreak(out);
 
+		if (!entityRelations.empty()) {
+			writeLine(out, "virtual void collectInverseReferences(EarlyBinding::EXPRESSInverseCollector& collector) const override;");
+			linebreak(out);
+		}
+
 		writeLine(out, "using base::getStepParameter;");		
 	};
 
@@ -3462,6 +3943,14 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 		writeLine(out, "virtual const std::string getStepLine() const = 0;");
 	}
 
+	// Inverse attributes are answered from the inverse index of the model.
+	if (!entity.getInverseAttributes().empty()) {
+		linebreak(out);
+		for (const auto& inverse : entity.getInverseAttributes()) {
+			writeLine(out, "EarlyBinding::EXPRESSInverseRange<" + inverse.entity + "> " + inverse.name + "(const EarlyBinding::EXPRESSModel& model) const;");
+		}
+	}
+
 	if (!attributes.empty()) {
 		linebreak(out);
 	}
@@ -3473,6 +3962,20 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 		}
 	}
 
+	// Descriptors of all attributes in the order of the STEP record, see EarlyBinding::forEachAttribute.
+	linebreak(out);
+	const auto allAttributes = schema.getAllEntityAttributes(entity);
+	writeLine(out, "static constexpr auto attributes() {");
+	writeLine(out, allAttributes.empty() ? "return std::make_tuple();" : "return std::make_tuple(");
+	for (size_t i = 0; i < allAttributes.size(); i++) {
+		bool aggregate = false;
+		const std::string kind = getAttributeKind(schema, allAttributes[i], aggregate);
+		writeLine(out, "EarlyBinding::describeAttribute<" + entity.getName() + ">(\"" + allAttributes[i].getName() + "\", " + std::to_string(i)
+			+ ", EarlyBinding::EXPRESSAttributeKind::" + kind + ", " + (allAttributes[i].isOptional() ? "true" : "false") + ", " + (aggregate ? "true" : "false")
+			+ ", &" + entity.getName() + "::" + allAttributes[i].getName() + ")" + (i + 1 < allAttributes.size() ? "," : ");"));
+	}
+	writeLine(out, "}");
+
 	writeLine(out, "};");
 	writeEndNamespace(out, schema);
 
@@ -3490,6 +3993,11 @@ void GeneratorOIP::generateEntityHeaderFileREFACTORED(Schema & schema, Entity &
 		linebreak(out);
 	}
 
+	// Instantiated once in the source file of the entity.
+	writeLine(out, "extern template class OpenInfraPlatform::EarlyBinding::EXPRESSReference<OpenInfraPlatform::" + schema.getName() + "::" + entity.getName() + ">;");
+	writeLine(out, "extern template class OpenInfraPlatform::EarlyBinding::EXPRESSOptional<OpenInfraPlatform::EarlyBinding::EXPRESSReference<OpenInfraPlatform::" + schema.getName() + "::" + entity.getName() + ">" + ">;");
+	linebreak(out);
+
 	writeLine(out, "#endif // end define " + define);
 	out.close();
 }
@@ -3502,13 +4010,7 @@ void GeneratorOIP::generateEntityEnumsHeaderFile(Schema &schema) {
 
 	writeLicenseAndNotice(out);
 
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), "Enums", guid, "h" }, '_');
+	std::string define = includeGuard(schema, "Enums");
 
 	writeLine(out, "#pragma once");
 	writeLine(out, "#ifndef " + define);
@@ -3530,16 +4032,10 @@ void GeneratorOIP::generateEntityEnumsHeaderFile(Schema &schema) {
 
 void GeneratorOIP::generateSchemaHeader(Schema & schema)
 {
-	std::ofstream file(sourceDirectory_ + "/"+ schema.getName().append(".h"));
+	GeneratedFile file(sourceDirectory_ + "/"+ schema.getName().append(".h"));
 
 	writeLicenseAndNotice(file);
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), schema.getName(), guid, "h" }, '_');
+	std::string define = includeGuard(schema, schema.getName());
 
 	writeLine(file, "#pragma once");
 	writeLine(file, "#ifndef " + define);
@@ -3558,16 +4054,10 @@ void GeneratorOIP::generateSchemaHeader(Schema & schema)
 
 void GeneratorOIP::generateNamespaceHeader(Schema & schema)
 {
-	std::ofstream file(sourceDirectory_ + "/" + schema.getName().append("Namespace.h"));
+	GeneratedFile file(sourceDirectory_ + "/" + schema.getName().append("Namespace.h"));
 
 	writeLicenseAndNotice(file);
-	boost::mt19937 ran;
-	auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	ran.seed(time(&now)); // one should likely seed in a better way
-	boost::uuids::basic_random_generator<boost::mt19937> gen(&ran);
-	auto guid = boost::uuids::to_string(gen());
-	std::replace(guid.begin(), guid.end(), '-', '_');
-	std::string define = join(std::vector<std::string>{ "OpenInfraPlatform", schema.getName(), "Namespace", guid, "h" }, '_');
+	std::string define = includeGuard(schema, "Namespace");
 
 	writeLine(file, "#pragma once");
 	writeLine(file, "#ifndef " + define);
@@ -3598,6 +4088,35 @@ void GeneratorOIP::generateNamespaceHeader(Schema & schema)
 	file.close();
 }
 
+void GeneratorOIP::generateForwardHeader(Schema & schema)
+{
+	GeneratedFile file(sourceDirectory_ + "/" + schema.getName().append("Forward.h"));
+
+	writeLicenseAndNotice(file);
+	std::string define = includeGuard(schema, "Forward");
+
+	writeLine(file, "#pragma once");
+	writeLine(file, "#ifndef " + define);
+	writeLine(file, "#define " + define);
+	linebreak(file);
+
+	// Declarations only, headers that merely refer to entities and types include this instead of their definitions.
+	writeBeginNamespace(file, schema);
+
+	for (size_t idx = 0; idx < schema.getEntityCount(); idx++) {
+		writeLine(file, "class " + schema.getEntityByIndex(idx).getName() + ";");
+	}
+	for (size_t idx = 0; idx < schema.getTypeCount(); idx++) {
+		writeLine(file, "class " + schema.getTypeByIndex(idx).getName() + ";");
+	}
+
+	writeEndNamespace(file, schema);
+
+	writeLine(file, "#endif // end define " + define);
+
+	file.close();
+}
+
 void GeneratorOIP::generateEntitySourceFile(Schema &schema, const Entity &entity) {
 	std::stringstream ssHeaderFilename;
 	ssHeaderFilename << entityPath_ << "/" << entity.getName() << ".cpp";
@@ -3882,12 +4401,12 @@ void GeneratorOIP::generateEntitySourceFile(Schema &schema, const Entity &entity
 	writeEndNamespace(out, schema);
 }
 
-void GeneratorOIP::generateEntitySourceFileREFACTORED(Schema & schema, const Entity & entity)
+void GeneratorOIP::generateEntitySourceFileREFACTORED(Schema & schema, const Entity & entity, const std::vector<std::pair<std::string, std::string>> &inverseRelations)
 {
 	std::stringstream ssSourceFilename;
 	ssSourceFilename << entityPath_ << "/" << entity.getName() << ".cpp";
 	//std::cout << ssHeaderFilename.str() << std::endl;
-	std::ofstream out(ssSourceFilename.str());
+	GeneratedFile out(ssSourceFilename.str());
 
 	indentation = 0;
 
@@ -3960,7 +4479,7 @@ void GeneratorOIP::generateEntitySourceFileREFACTORED(Schema & schema, const Ent
 	writeBeginNamespace(out, schema);
 	
 
-	auto initClassAsDefault = [&out, &entity, &schema]() {
+	auto initClassAsDefault = [&out, &entity, &schema, &inverseRelations]() {
 
 		// Default constructor
 		writeLine(out, entity.getName() + "::" + entity.getName() + "() { }");
@@ -4000,25 +4519,68 @@ void GeneratorOIP::generateEntitySourceFileREFACTORED(Schema & schema, const Ent
 
 		auto attributes = schema.getAllEntityAttributes(entity);
 
-		writeLine(out, entity.getName() + " " + entity.getName() +"::readStepData(const std::vector<std::string>& args, const std::shared_ptr<EarlyBinding::EXPRESSModel>& model) {");
-		writeLine(out, entity.getName() + " entity;");
-		writeLine(out, "entity.setId(stoull(args[0]));");
+		writeLine(out, "void " + entity.getName() + "::readStepData(" + entity.getName() + "& entity, const std::vector<boost::string_view>& args, const std::shared_ptr<EarlyBinding::EXPRESSModel>& model) {");
+		writeLine(out, "entity.setId(EarlyBinding::EXPRESSTokenizer::toId(args[0]));");
 		for (int i = 0; i < attributes.size(); i++) {
 			auto attr = attributes[i];
 			writeLine(out, "entity." + attr.getName() + " = decltype(" + attr.getName() + ")::readStepData(args[" + std::to_string(i + 1) + "], model);");
 		}
-		writeLine(out, "return entity;");
 		writeLine(out, "}");
 		linebreak(out);
 
-		writeLine(out, "const std::string " + entity.getName() + "::getStepLine() const {");
-		writeLine(out, "std::string stepLine = this->getStepParameter() + \"=\" + this->classname() + \"(\";");
-		for (int i = 0; i < attributes.size() - 1; i++) {
-			writeLine(out, "stepLine += " + attributes[i].getName() + ".getStepParameter() + \",\";");
+		writeLine(out, "void " + entity.getName() + "::linkReferences(const EarlyBinding::EXPRESSModel& model, std::vector<size_t>& unresolved) {");
+		for (auto& attr : attributes) {
+			writeLine(out, attr.getName() + ".link(model, unresolved);");
+		}
+		writeLine(out, "}");
+		linebreak(out);
+
+		const auto entityRelations = getInverseRelationsOf(schema, entity, inverseRelations);
+		if (!entityRelations.empty()) {
+			writeLine(out, "void " + entity.getName() + "::collectInverseReferences(EarlyBinding::EXPRESSInverseCollector& collector) const {");
+			writeLine(out, "this->decode();");
+			for (const auto& relation : entityRelations) {
+				writeLine(out, "collector.add(" + std::to_string(relation.first) + ", " + relation.second + ");");
+			}
+			writeLine(out, "}");
+			linebreak(out);
 		}
-		writeLine(out, "stepLine += " + attributes.back().getName() + ".getStepParameter() + \")\";");
+
+		writeLine(out, "void " + entity.getName() + "::writeSnapshot(EarlyBinding::EXPRESSSnapshotWriter& out) const {");
+		writeLine(out, "this->decode();");
+		for (auto& attr : attributes) {
+			writeLine(out, attr.getName() + ".writeSnapshot(out);");
+		}
+		writeLine(out, "}");
+		linebreak(out);
+
+		writeLine(out, "void " + entity.getName() + "::readSnapshot(EarlyBinding::EXPRESSSnapshotReader& in) {");
+		for (auto& attr : attributes) {
+			writeLine(out, attr.getName() + ".readSnapshot(in);");
+		}
+		writeLine(out, "}");
+		linebreak(out);
+
+		writeLine(out, "const std::string " + entity.getName() + "::getStepLine() const {");
+		writeLine(out, "std::string stepLine;");
+		writeLine(out, "writeStepLine(stepLine);");
 		writeLine(out, "return stepLine;");
 		writeLine(out, "}");
+		linebreak(out);
+
+		writeLine(out, "void " + entity.getName() + "::writeStepLine(std::string& out) const {");
+		writeLine(out, "this->decode();");
+		writeLine(out, "out += '#';");
+		writeLine(out, "EarlyBinding::EXPRESSStepFormat::appendInteger(out, m_id);");
+		writeLine(out, "out += \"=" + toUpper(entity.getName()) + "(\";");
+		for (int i = 0; i < attributes.size(); i++) {
+			if (i > 0) {
+				writeLine(out, "out += ',';");
+			}
+			writeLine(out, attributes[i].getName() + ".writeStepParameter(out);");
+		}
+		writeLine(out, "out += ')';");
+		writeLine(out, "}");
 	};
 
 	if (!schema.isAbstract(entity)) {
@@ -4034,6 +4596,17 @@ void GeneratorOIP::generateEntitySourceFileREFACTORED(Schema & schema, const Ent
 
 		initClassAsDefault();		
 	}
+
+	writeLine(out, "constexpr uint32_t " + entity.getName() + "::TypeId;");
+	writeLine(out, "constexpr uint32_t " + entity.getName() + "::SubtypeCount;");
+	linebreak(out);
+
+	for (const auto& inverse : entity.getInverseAttributes()) {
+		writeLine(out, "EarlyBinding::EXPRESSInverseRange<" + inverse.entity + "> " + entity.getName() + "::" + inverse.name + "(const EarlyBinding::EXPRESSModel& model) const {");
+		writeLine(out, "return model.inverses().find<" + inverse.entity + ">(m_id, " + std::to_string(getInverseRelation(inverseRelations, inverse)) + ");");
+		writeLine(out, "}");
+		linebreak(out);
+	}
 		
 	writeEndNamespace(out, schema);
 
@@ -27,6 +27,9 @@
 #include "Meta/Schema.h"
 #include "General/namespace.h"
 #include <iostream>
+#include <map>
+#include <vector>
+#include <cstdint>
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EXPRESSBINDINGGENERATOR_BEGIN
 
@@ -40,6 +43,9 @@ public:
 
 	void generateREFACTORED(std::ostream &out, Schema &schema);
 
+	/// Compiles the type and entity sources in unity files of the given number of sources, 0 compiles them one by one.
+	void setUnityBuild(size_t sourcesPerUnit);
+
 private:
     void createEntitiesMapHeaderFile(Schema &schema);
 
@@ -53,7 +59,7 @@ private:
 
 	void generateEntitySourceFile(Schema &schema, const Entity &entity);
 
-	void generateEntitySourceFileREFACTORED(Schema &schema, const Entity &entity);
+	void generateEntitySourceFileREFACTORED(Schema &schema, const Entity &entity, const std::vector<std::pair<std::string, std::string>> &inverseRelations);
 
     void generateTypeHeaderFile(Schema &schema, Type &type);
 
@@ -84,7 +90,7 @@ private:
 
     void generateEntityHeaderFile(Schema &schema, Entity &entity);
 
-	void generateEntityHeaderFileREFACTORED(Schema &schema, Entity &entity);
+	void generateEntityHeaderFileREFACTORED(Schema &schema, Entity &entity, const std::map<std::string, std::pair<uint32_t, uint32_t>> &typeIds, const std::vector<std::pair<std::string, std::string>> &inverseRelations);
 
     void generateEntityEnumsHeaderFile(Schema &schema);
 
@@ -92,6 +98,12 @@ private:
 
 	void generateNamespaceHeader(Schema &schema);
 
+	void generateForwardHeader(Schema &schema);
+
+	void generateUnitySourceFiles(Schema &schema);
+
+	void removeStaleFiles(Schema &schema);
+
 private:
     std::string outputDirectory_;
     std::string rootDirectory_;
@@ -100,9 +112,11 @@ private:
     std::string entityPath_;
 	std::string typePath_;
     std::string readerPath_;
+	std::string unityPath_;
     std::string modelPath_;
     std::string writerPath_;
     std::string xmlPath_;
+	size_t sourcesPerUnit_;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EXPRESSBINDINGGENERATOR_END
@@ -36,6 +36,13 @@ struct qualifiedAttribute {
 	std::string attributeQualifier;
 };
 
+// INVERSE name : SET OF entity FOR attribute;
+struct inverseAttribute {
+	std::string name;
+	std::string entity;
+	std::string attribute;
+};
+
 class Entity {
   public:
     Entity();
@@ -113,12 +120,24 @@ class Entity {
 	}
 
 
+	//---------------------------------------------------------------
+	// Inverse Attributes
+	//---------------------------------------------------------------
+	void addInverseAttribute(const inverseAttribute& attribute) {
+		inverseAttributes_.push_back(attribute);
+	}
+
+	const std::vector<inverseAttribute>& getInverseAttributes() const {
+		return inverseAttributes_;
+	}
+
   private:
     std::string parentEntity_;
     std::string name_;
     std::vector<std::string> subtypes_;
     std::vector<EntityAttribute> attributes_;
 	std::vector<qualifiedAttribute> qualifiedAttributes_;
+	std::vector<inverseAttribute> inverseAttributes_;
 };
 
 OIP_NAMESPACE_OPENINFRAPLATFORM_EXPRESSBINDINGGENERATOR_END
@@ -1311,7 +1311,18 @@ inverse_clause2:
   | inverse_attr inverse_clause2;
 
 inverse_attr:
-	attribute_decl TOKEN_COLON inverse_attr1 entity_ref TOKEN_FOR attribute_ref inverse_attr4 TOKEN_SEMICOLON;
+	attribute_decl TOKEN_COLON inverse_attr1 entity_ref TOKEN_FOR inverse_attr4 TOKEN_SEMICOLON
+	{
+		inverseAttribute inverse;
+		inverse.attribute = attribute_ids.top();
+		attribute_ids.pop();
+		inverse.name = attribute_ids.top();
+		attribute_ids.pop();
+		inverse.entity = ids.top();
+		ids.pop();
+
+		currentEntity.addInverseAttribute(inverse);
+	};
 
 inverse_attr1:
 	%empty
@@ -1326,8 +1337,12 @@ inverse_attr3:
   | bound_spec;
 
 inverse_attr4:
-	%empty
-  | entity_ref TOKEN_PERIOD;
+	attribute_ref
+  | entity_ref TOKEN_PERIOD attribute_ref
+	{
+		// the qualifier names the entity that declares the attribute, the inverse refers to the entity before FOR
+		ids.pop();
+	};
 	
 attribute_ref:
 	attribute_id;
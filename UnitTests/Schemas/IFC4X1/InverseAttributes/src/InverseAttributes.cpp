@@ -0,0 +1,71 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <reader/IFC4X1Reader.h>
+#include <IFC4X1Entities.h>
+#include <namespace.h>
+
+using namespace testing;
+using namespace OpenInfraPlatform::IFC4X1;
+
+class InverseAttributesTest : public Test {
+protected:
+    virtual void SetUp() override {
+        model = IFC4X1Reader::FromFile(filename);
+    }
+
+    virtual void TearDown() override {
+        model.reset();
+    }
+
+    template <typename T> T& entity(size_t id) const {
+        return dynamic_cast<T&>(*model->entities.get(id));
+    }
+
+
+    const std::string filename = "UnitTests/Schemas/IFC4X1/Data/csg-primitive.ifc";
+    std::shared_ptr<oip::EXPRESSModel> model = nullptr;
+
+};
+
+TEST_F(InverseAttributesTest, AggregationIsFoundFromBothEnds) {
+    auto decomposedBy = entity<IfcProject>(1).IsDecomposedBy(*model);
+    ASSERT_THAT(decomposedBy.size(), Eq(1));
+    EXPECT_THAT(decomposedBy[0].getId(), Eq(5));
+
+    auto decomposes = entity<IfcBuilding>(25).Decomposes(*model);
+    ASSERT_THAT(decomposes.size(), Eq(1));
+    EXPECT_THAT(decomposes[0].getId(), Eq(5));
+}
+
+TEST_F(InverseAttributesTest, ReferencesInsideAggregatesAreFound) {
+    auto containedIn = entity<IfcBuildingElementProxy>(22).ContainedInStructure(*model);
+    ASSERT_THAT(containedIn.size(), Eq(1));
+    EXPECT_THAT(containedIn[0].getId(), Eq(27));
+
+    auto contains = entity<IfcBuilding>(25).ContainsElements(*model);
+    ASSERT_THAT(contains.size(), Eq(1));
+    EXPECT_THAT(contains[0].getId(), Eq(27));
+}
+
+TEST_F(InverseAttributesTest, UnreferencedEntitiesHaveEmptyInverses) {
+    EXPECT_THAT(entity<IfcBuildingElementProxy>(22).HasOpenings(*model).empty(), IsTrue());
+    EXPECT_THAT(entity<IfcProject>(1).Decomposes(*model).empty(), IsTrue());
+}
@@ -0,0 +1,59 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <reader/IFC4X1Reader.h>
+#include <namespace.h>
+
+using namespace testing;
+
+class MultiLineTest : public Test {
+protected:
+    virtual void SetUp() override {
+        express_model = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFile(filename);
+    }
+
+    virtual void TearDown() override {
+        express_model.reset();
+    }
+
+
+    const std::string filename = "UnitTests/Schemas/IFC4X1/Data/csg-primitive.ifc";
+    std::shared_ptr<oip::EXPRESSModel> express_model = nullptr;
+
+};
+
+TEST_F(MultiLineTest, AllEntitiesAreRead) {
+    EXPECT_THAT(express_model->entities.size(), Eq(31));
+}
+
+TEST_F(MultiLineTest, WrappedEntitiesAreRead) {
+    EXPECT_THAT(express_model->entities[4]->classname(), Eq("IfcUnitAssignment"));
+    EXPECT_THAT(express_model->entities[17]->classname(), Eq("IfcMeasureWithUnit"));
+    EXPECT_THAT(express_model->entities[25]->classname(), Eq("IfcBuilding"));
+}
+
+TEST_F(MultiLineTest, SeveralEntitiesOnOneLineAreRead) {
+    EXPECT_THAT(express_model->entities[20]->classname(), Eq("IfcSIUnit"));
+    EXPECT_THAT(express_model->entities[21]->classname(), Eq("IfcBlock"));
+}
+
+TEST_F(MultiLineTest, StringLiteralsDoNotEndStatements) {
+    EXPECT_THAT(express_model->entities[7]->getStepLine(), HasSubstr("'IFC text editor; don''t trust it'"));
+}
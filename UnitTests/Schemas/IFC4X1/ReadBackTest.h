@@ -0,0 +1,73 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#ifndef A3E9C1D4_5B7F_4E2A_9C61_2F8D0B4E7A19
+#define A3E9C1D4_5B7F_4E2A_9C61_2F8D0B4E7A19
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <reader/IFC4X1Reader.h>
+#include <namespace.h>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+OIP_NAMESPACE_UNITTESTS_SCHEMA_IFCX41_BEGIN
+
+/// Base of the tests that store the model of the shared fixture, e.g. as STEP file or snapshot, and read it back.
+/// The tests set model and read_back_model in SetUp, expectSameEntities compares both.
+class ReadBackTest : public testing::Test {
+protected:
+    virtual void TearDown() override {
+        model.reset();
+        read_back_model.reset();
+    }
+
+    /// Expects read_back_model to contain every entity of model with the same STEP line.
+    void expectSameEntities() const {
+        ASSERT_THAT(read_back_model, testing::NotNull());
+        EXPECT_THAT(read_back_model->entities.size(), testing::Eq(model->entities.size()));
+        for (const auto& entity : model->entities) {
+            ASSERT_THAT(read_back_model->entities.count(entity.first), testing::Eq(1));
+            EXPECT_THAT(read_back_model->entities.get(entity.first)->getStepLine(), testing::Eq(entity.second->getStepLine()));
+        }
+    }
+
+    static std::string readFile(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    static void writeFile(const std::string& filename, const std::string& content) {
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), content.size());
+    }
+
+
+    const std::string fixture = "UnitTests/Schemas/IFC4X1/Data/csg-primitive.ifc";
+    std::shared_ptr<oip::EXPRESSModel> model = nullptr;
+    std::shared_ptr<oip::EXPRESSModel> read_back_model = nullptr;
+
+};
+
+OIP_NAMESPACE_UNITTESTS_SCHEMA_IFCX41_END
+
+#endif /* A3E9C1D4_5B7F_4E2A_9C61_2F8D0B4E7A19 */
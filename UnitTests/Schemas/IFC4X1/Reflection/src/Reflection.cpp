@@ -0,0 +1,77 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <reader/IFC4X1Reader.h>
+#include <IFC4X1Entities.h>
+#include <EXPRESS/EXPRESSReflection.h>
+#include <namespace.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace OpenInfraPlatform::IFC4X1;
+
+class ReflectionTest : public Test {
+protected:
+    virtual void SetUp() override {
+        model = IFC4X1Reader::FromFile(filename, true);
+    }
+
+    virtual void TearDown() override {
+        model.reset();
+    }
+
+
+    const std::string filename = "UnitTests/Schemas/IFC4X1/Data/csg-primitive.ifc";
+    std::shared_ptr<oip::EXPRESSModel> model = nullptr;
+
+};
+
+TEST_F(ReflectionTest, AttributesAreDescribed) {
+    EXPECT_THAT(oip::attributeCount<IfcCartesianPoint>(), Eq(1));
+    EXPECT_THAT(std::string(std::get<0>(IfcCartesianPoint::attributes()).name), Eq("Coordinates"));
+}
+
+TEST_F(ReflectionTest, LazyEntityIsDecodedBeforeItsAttributesAreVisited) {
+    ASSERT_THAT(model, NotNull());
+    const IfcCartesianPoint& point = dynamic_cast<const IfcCartesianPoint&>(*model->entities.get(24));
+
+    std::vector<std::string> names;
+    std::vector<double> coordinates;
+    oip::forEachAttribute(point, [&](const auto& descriptor, const auto& value) {
+        names.push_back(descriptor.name);
+        for (const auto& coordinate : value)
+            coordinates.push_back(coordinate);
+    });
+
+    EXPECT_THAT(names, ElementsAre("Coordinates"));
+    EXPECT_THAT(coordinates, ElementsAre(DoubleEq(-500.0), DoubleEq(-500.0), DoubleEq(0.0)));
+}
+
+TEST_F(ReflectionTest, LazyEntityOutlivingItsModelThrowsOnDecode) {
+    ASSERT_THAT(model, NotNull());
+    const std::shared_ptr<oip::EXPRESSEntity> point = model->entities.get(24);
+    ASSERT_THAT(point, NotNull());
+
+    model.reset();
+    EXPECT_THROW(point->decode(), std::runtime_error);
+}
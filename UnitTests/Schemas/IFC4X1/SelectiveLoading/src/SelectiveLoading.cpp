@@ -0,0 +1,64 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <reader/IFC4X1Reader.h>
+#include <namespace.h>
+
+#include <stdexcept>
+
+using namespace testing;
+using namespace OpenInfraPlatform::IFC4X1;
+
+class SelectiveLoadingTest : public Test {
+protected:
+    const std::string filename = "UnitTests/Schemas/IFC4X1/Data/csg-primitive.ifc";
+
+};
+
+TEST_F(SelectiveLoadingTest, ContainedProductsOfTheSpatialStructureAreRead) {
+    const auto model = IFC4X1Reader::FromFile(filename, std::vector<std::string>{ "IfcBuilding" });
+    ASSERT_THAT(model, NotNull());
+    // #27 IfcRelContainedInSpatialStructure refers to the building, #22 IfcBuildingElementProxy and its #21 IfcBlock are referenced by it
+    EXPECT_THAT(model->entities.count(27), Eq(1));
+    EXPECT_THAT(model->entities.count(22), Eq(1));
+    EXPECT_THAT(model->entities.count(21), Eq(1));
+}
+
+TEST_F(SelectiveLoadingTest, OnlyRelationsOfTheMatchedEntitiesAreFollowed) {
+    const auto model = IFC4X1Reader::FromFile(filename, std::vector<std::string>{ "IfcBuildingElementProxy" });
+    ASSERT_THAT(model, NotNull());
+    EXPECT_THAT(model->entities.count(22), Eq(1));
+    EXPECT_THAT(model->entities.count(27), Eq(1));
+    EXPECT_THAT(model->entities.count(25), Eq(1));
+    // #5 IfcRelAggregates refers to the building only, neither it nor the project it references are read
+    EXPECT_THAT(model->entities.count(5), Eq(0));
+    EXPECT_THAT(model->entities.count(1), Eq(0));
+}
+
+TEST_F(SelectiveLoadingTest, RootsRestrictTheMatchedEntities) {
+    const auto model = IFC4X1Reader::FromFile(filename, std::vector<std::string>{ "IfcProduct" }, { 22 });
+    ASSERT_THAT(model, NotNull());
+    EXPECT_THAT(model->entities.count(22), Eq(1));
+    EXPECT_THAT(model->entities.count(5), Eq(0));
+}
+
+TEST_F(SelectiveLoadingTest, UnknownTypeIsRejected) {
+    EXPECT_THROW(IFC4X1Reader::FromFile(filename, std::vector<std::string>{ "IfcNoSuchType" }), std::invalid_argument);
+}
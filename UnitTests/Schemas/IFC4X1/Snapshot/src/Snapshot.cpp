@@ -0,0 +1,116 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <ReadBackTest.h>
+#include <EXPRESS/EXPRESSSnapshotFile.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace testing;
+
+class SnapshotTest : public OpenInfraPlatform::UnitTests::Schema::IFC4X1::ReadBackTest {
+protected:
+    virtual void SetUp() override {
+        // The tests work on a copy, so they can change the file without touching the shared fixture.
+        writeFile(filename, readFile(fixture));
+        snapshot = oip::EXPRESSSnapshotFile::pathFor(filename, cacheDirectory);
+        std::remove(snapshot.c_str());
+        model = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFileCached(filename, cacheDirectory);
+        read_back_model = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromSnapshot(filename, cacheDirectory);
+    }
+
+    virtual void TearDown() override {
+        ReadBackTest::TearDown();
+        // A changed file has a snapshot of its own.
+        std::remove(oip::EXPRESSSnapshotFile::pathFor(filename, cacheDirectory).c_str());
+        std::remove(snapshot.c_str());
+        std::remove(filename.c_str());
+    }
+
+
+    const std::string filename = "UnitTests/Schemas/IFC4X1/Data/csg-primitive-snapshot.ifc";
+    const std::string cacheDirectory = "UnitTests/Schemas/IFC4X1/Data";
+    std::string snapshot;
+
+};
+
+TEST_F(SnapshotTest, SnapshotIsWrittenToTheCacheDirectory) {
+    EXPECT_TRUE(std::ifstream(snapshot).good());
+    EXPECT_FALSE(std::ifstream(filename + ".snapshot").good());
+}
+
+TEST_F(SnapshotTest, FileIsReadWithoutCacheDirectory) {
+    std::remove(snapshot.c_str());
+    const auto uncached_model = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFileCached(filename, "");
+    ASSERT_THAT(uncached_model, NotNull());
+    EXPECT_THAT(uncached_model->entities.size(), Eq(model->entities.size()));
+    EXPECT_FALSE(std::ifstream(snapshot).good());
+}
+
+TEST_F(SnapshotTest, UnwritableCacheDirectoryIsIgnored) {
+    const auto uncached_model = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFileCached(filename, cacheDirectory + "/missing");
+    ASSERT_THAT(uncached_model, NotNull());
+    EXPECT_THAT(uncached_model->entities.size(), Eq(model->entities.size()));
+}
+
+TEST_F(SnapshotTest, SnapshotIsLoaded) {
+    EXPECT_THAT(read_back_model, NotNull());
+}
+
+TEST_F(SnapshotTest, EntitiesAreRestored) {
+    expectSameEntities();
+}
+
+TEST_F(SnapshotTest, MissingSnapshotIsRejected) {
+    std::remove(snapshot.c_str());
+    EXPECT_THAT(OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromSnapshot(filename, cacheDirectory), IsNull());
+}
+
+TEST_F(SnapshotTest, StaleSnapshotIsRejected) {
+    // The size and likely the modification time stay the same, only the content hash tells the files apart.
+    std::string content = readFile(filename);
+    const size_t name = content.find("proxy with CSG");
+    ASSERT_THAT(name, Ne(std::string::npos));
+    content.replace(name, 14, "proxy with ABC");
+    writeFile(filename, content);
+
+    EXPECT_THAT(OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromSnapshot(filename, cacheDirectory), IsNull());
+}
+
+TEST_F(SnapshotTest, StaleSnapshotIsReplaced) {
+    writeFile(filename, readFile(filename) + "\n");
+    const auto changed_model = OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromFileCached(filename, cacheDirectory);
+    ASSERT_THAT(changed_model, NotNull());
+    EXPECT_THAT(changed_model->entities.size(), Eq(model->entities.size()));
+    EXPECT_THAT(OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromSnapshot(filename, cacheDirectory), NotNull());
+}
+
+TEST_F(SnapshotTest, TruncatedSnapshotIsRejected) {
+    const std::string content = readFile(snapshot);
+    writeFile(snapshot, content.substr(0, content.size() / 2));
+    EXPECT_THAT(OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromSnapshot(filename, cacheDirectory), IsNull());
+}
+
+TEST_F(SnapshotTest, DamagedSignatureIsRejected) {
+    std::string content = readFile(snapshot);
+    ASSERT_THAT(content.empty(), IsFalse());
+    content[0] = 'X';
+    writeFile(snapshot, content);
+    EXPECT_THAT(OpenInfraPlatform::IFC4X1::IFC4X1Reader::FromSnapshot(filename, cacheDirectory), IsNull());
+}
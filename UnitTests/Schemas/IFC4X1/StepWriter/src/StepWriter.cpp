@@ -0,0 +1,69 @@
+/*
+    Copyright (c) 2020 Technical University of Munich
+    Chair of Computational Modeling and Simulation.
+
+    TUM Open Infra Platform is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License Version 3
+    as published by the Free Software Foundation.
+
+    TUM Open Infra Platform is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <ReadBackTest.h>
+#include <IFC4X1Entities.h>
+#include <EXPRESS/EXPRESSStepWriter.h>
+
+#include <cstdio>
+#include <string>
+
+using namespace testing;
+using namespace OpenInfraPlatform::IFC4X1;
+
+class StepWriterTest : public OpenInfraPlatform::UnitTests::Schema::IFC4X1::ReadBackTest {
+protected:
+    virtual void SetUp() override {
+        model = IFC4X1Reader::FromFile(fixture);
+        oip::EXPRESSStepWriter::write(*model, written);
+        read_back_model = IFC4X1Reader::FromFile(written);
+    }
+
+    virtual void TearDown() override {
+        ReadBackTest::TearDown();
+        std::remove(written.c_str());
+    }
+
+    template <typename T> static T& entity(oip::EXPRESSModel& model, size_t id) {
+        return dynamic_cast<T&>(*model.entities.get(id));
+    }
+
+
+    const std::string written = fixture + ".written.ifc";
+
+};
+
+TEST_F(StepWriterTest, WrittenFileReadsBackUnchanged) {
+    expectSameEntities();
+}
+
+TEST_F(StepWriterTest, RealWithExponentIsReadBack) {
+    auto& context = entity<IfcGeometricRepresentationContext>(*read_back_model, 3);
+    ASSERT_THAT(context.Precision.is_initialized(), IsTrue());
+    EXPECT_THAT(static_cast<double>(context.Precision.get()), DoubleEq(1.0E-05));
+}
+
+TEST_F(StepWriterTest, EscapedQuoteIsReadAndWritten) {
+    EXPECT_THAT(static_cast<std::string>(entity<IfcApplication>(*model, 7).ApplicationFullName), Eq("IFC text editor; don't trust it"));
+    EXPECT_THAT(readFile(written), HasSubstr("'IFC text editor; don''t trust it'"));
+    EXPECT_THAT(static_cast<std::string>(entity<IfcApplication>(*read_back_model, 7).ApplicationFullName), Eq("IFC text editor; don't trust it"));
+}
+
+TEST_F(StepWriterTest, EncodedCharactersAreWrittenUnchanged) {
+    EXPECT_THAT(readFile(written), HasSubstr("'buildingSMART International (\\X2\\00DC\\X0\\ber)'"));
+    EXPECT_THAT(static_cast<std::string>(entity<IfcOrganization>(*read_back_model, 13).Name), Eq("buildingSMART International (\\X2\\00DC\\X0\\ber)"));
+}
@@ -57,17 +57,37 @@ void IfcGeometryEffect::setIfcGeometryModel(buw::ReferenceCounted<Core::IfcGeome
         buw::indexBufferDescription ibd;
         valid_ = true;        
 
-		if(!ifcGeometryModel->meshDescription_.isEmpty()) {
+		if(!ifcGeometryModel->meshDescription_.isEmpty() || !ifcGeometryModel->instances_.empty()) {
+
+			Core::IfcGeometryConverter::IndexedMeshDescription& meshDescription = ifcGeometryModel->meshDescription_;
+
+			// the instances are drawn from the same buffers as the other triangles, they follow the triangles of the model
+			size_t instanceVertexCount = 0;
+			size_t instanceIndexCount = 0;
+			for (const auto& instance : ifcGeometryModel->instances_)
+			{
+				instanceVertexCount += ifcGeometryModel->prototypes_[instance.prototype].vertices.size();
+				instanceIndexCount += ifcGeometryModel->prototypes_[instance.prototype].indices.size();
+			}
 
 			std::vector< VertexLayout> vertices;
-			vertices.reserve(ifcGeometryModel->meshDescription_.vertices.size());
-			for (auto& vertex : ifcGeometryModel->meshDescription_.vertices)
+			vertices.reserve(meshDescription.vertices.size() + instanceVertexCount);
+			vertices.insert(vertices.end(), meshDescription.vertices.begin(), meshDescription.vertices.end());
+
+			std::vector<uint32_t> instancedIndices;
+			if (!ifcGeometryModel->instances_.empty())
+			{
+				instancedIndices.reserve(meshDescription.indices.size() + instanceIndexCount);
+				instancedIndices.insert(instancedIndices.end(), meshDescription.indices.begin(), meshDescription.indices.end());
+				ifcGeometryModel->appendInstanceTriangles(vertices, instancedIndices);
+			}
+			std::vector<uint32_t>& indices = ifcGeometryModel->instances_.empty() ? meshDescription.indices : instancedIndices;
+
+			for (auto& vtx : vertices)
 			{
-				VertexLayout vtx(vertex);
 				vtx.position[0] += offset.x();
 				vtx.position[1] += offset.y();
 				vtx.position[2] += offset.z();
-				vertices.push_back( vtx );
 			}
 
 			vbd.data = vertices.data(); // &ifcGeometryModel->meshDescription_.vertices[0];
@@ -80,8 +100,8 @@ void IfcGeometryEffect::setIfcGeometryModel(buw::ReferenceCounted<Core::IfcGeome
 
 			BLUE_LOG(trace) << "Done creating IFC geometry meshes vertex buffer. Size:" << QString::number(vertices.size()).toStdString();
 
-            ibd.data = &ifcGeometryModel->meshDescription_.indices[0];
-            ibd.indexCount = ifcGeometryModel->meshDescription_.indices.size();
+            ibd.data = indices.data();
+            ibd.indexCount = indices.size();
             ibd.format = buw::eIndexBufferFormat::UnsignedInt32;
 
             if(meshIndexBuffer_)
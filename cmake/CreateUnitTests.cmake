@@ -61,4 +61,13 @@ function(CreateIfcFileUnitTestForSchema test_name schema)
         COMMAND	${CMAKE_COMMAND} -E copy_directory ${CMAKE_SOURCE_DIR}/${UnitTest_Data_Rel_Path} ${CMAKE_BINARY_DIR}/$<CONFIG>/${UnitTest_Data_Rel_Path}
     )
 
+    # Files used by several tests of the schema are kept once in the Data directory of the schema.
+    set(UnitTest_Shared_Data_Rel_Path UnitTests/Schemas/${schema}/Data)
+    if(EXISTS ${CMAKE_SOURCE_DIR}/${UnitTest_Shared_Data_Rel_Path})
+        add_custom_command(TARGET ${UnitTest_Executable_Name} POST_BUILD
+            COMMENT "Copying shared resources from '${CMAKE_SOURCE_DIR}/${UnitTest_Shared_Data_Rel_Path}' to '${CMAKE_BINARY_DIR}/$<CONFIG>/${UnitTest_Shared_Data_Rel_Path}'" VERBATIM
+            COMMAND	${CMAKE_COMMAND} -E copy_directory ${CMAKE_SOURCE_DIR}/${UnitTest_Shared_Data_Rel_Path} ${CMAKE_BINARY_DIR}/$<CONFIG>/${UnitTest_Shared_Data_Rel_Path}
+        )
+    endif()
+
 endfunction()
\ No newline at end of file
@@ -19,11 +19,16 @@
 
 #include <carve/carve.hpp>
 
+#include <atomic>
+
 namespace carve {
 
+  // Every thread tags with its own pass number. Pass numbers are drawn from a
+  // global counter, so concurrent passes on different meshes never share one.
   class tagable {
   private:
-    static int s_count;
+    static std::atomic<int> s_passes;
+    static thread_local int s_count;
 
   protected:
     mutable int __tag;
@@ -39,6 +44,6 @@ namespace carve {
     bool is_tagged() const { return __tag == s_count; }
     bool tag_once() const { if (__tag == s_count) return false; __tag = s_count; return true; }
 
-    static void tag_begin() { s_count++; }
+    static void tag_begin() { s_count = ++s_passes; }
   };
 }
@@ -21,4 +21,5 @@
 
 #include <carve/tag.hpp>
 
-int carve::tagable::s_count = 0;
+std::atomic<int> carve::tagable::s_passes(0);
+thread_local int carve::tagable::s_count = 0;